@@ -0,0 +1,148 @@
+#include "extension.h"
+
+AutoDeferrer g_AutoDeferrer;
+
+bool InteractionState::Claim(InteractionReply reply)
+{
+	int expected = InteractionReply_None;
+	if (!m_reply.compare_exchange_strong(expected, reply, std::memory_order_acq_rel)) {
+		return false;
+	}
+
+	g_AutoDeferrer.RecordResponseTime(std::chrono::steady_clock::now() - m_receivedAt);
+	return true;
+}
+
+AutoDeferrer::AutoDeferrer() :
+	m_shutdown(false),
+	m_delayMs(0),
+	m_ephemeral(false),
+	m_autoDeferred(0)
+{
+	ResetStats();
+}
+
+AutoDeferrer::~AutoDeferrer()
+{
+	Shutdown();
+}
+
+void AutoDeferrer::Track(const std::shared_ptr<InteractionState>& state, dpp::cluster* cluster, const dpp::interaction& interaction)
+{
+	const int delayMs = m_delayMs.load(std::memory_order_relaxed);
+	if (delayMs <= 0) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_shutdown) {
+		return;
+	}
+
+	if (!m_thread.joinable()) {
+		m_thread = std::thread(&AutoDeferrer::Run, this);
+	}
+
+	m_pending.push(Pending{
+		std::chrono::steady_clock::now() + std::chrono::milliseconds(delayMs),
+		state,
+		cluster,
+		interaction.id,
+		interaction.token,
+		interaction.channel_id,
+		interaction.guild_id
+	});
+	m_cv.notify_one();
+}
+
+void AutoDeferrer::RemoveCluster(const dpp::cluster* cluster)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	std::vector<Pending> kept;
+	while (!m_pending.empty()) {
+		if (m_pending.top().cluster != cluster) {
+			kept.push_back(m_pending.top());
+		}
+		m_pending.pop();
+	}
+
+	for (Pending& pending : kept) {
+		m_pending.push(std::move(pending));
+	}
+}
+
+void AutoDeferrer::Shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_shutdown = true;
+		m_pending = decltype(m_pending)();
+	}
+	m_cv.notify_one();
+
+	if (m_thread.joinable()) {
+		m_thread.join();
+	}
+}
+
+void AutoDeferrer::Run()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	while (!m_shutdown) {
+		if (m_pending.empty()) {
+			m_cv.wait(lock);
+			continue;
+		}
+
+		// Woken early by a new, possibly earlier, deadline or by shutdown
+		if (std::chrono::steady_clock::now() < m_pending.top().deadline) {
+			m_cv.wait_until(lock, m_pending.top().deadline);
+			continue;
+		}
+
+		Pending pending = m_pending.top();
+		m_pending.pop();
+
+		std::shared_ptr<InteractionState> state = pending.state.lock();
+		if (!state || !state->Claim(InteractionReply_Deferred)) {
+			continue;
+		}
+
+		// Same reply as dpp::interaction_create_t::thinking(), sent under the lock so
+		// RemoveCluster can not return while the cluster is still in use
+		dpp::message msg(pending.channelId, "*");
+		msg.guild_id = pending.guildId;
+		if (m_ephemeral.load(std::memory_order_relaxed)) {
+			msg.set_flags(dpp::m_ephemeral);
+		}
+		try {
+			pending.cluster->interaction_response_create(pending.id, pending.token,
+				dpp::interaction_response(dpp::ir_deferred_channel_message_with_source, msg));
+			m_autoDeferred.fetch_add(1, std::memory_order_relaxed);
+		}
+		catch (const std::exception& e) {
+			smutils->LogError(myself, "Failed to defer interaction: %s", e.what());
+		}
+	}
+}
+
+void AutoDeferrer::RecordResponseTime(std::chrono::steady_clock::duration elapsed)
+{
+	const int64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+
+	size_t bucket = 0;
+	while (bucket < RESPONSE_TIME_BUCKET_COUNT - 1 && ms >= g_ResponseTimeBuckets[bucket]) {
+		bucket++;
+	}
+	m_responseTimes[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void AutoDeferrer::ResetStats()
+{
+	m_autoDeferred.store(0, std::memory_order_relaxed);
+	for (std::atomic<uint64_t>& count : m_responseTimes) {
+		count.store(0, std::memory_order_relaxed);
+	}
+}
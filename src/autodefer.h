@@ -0,0 +1,118 @@
+#ifndef _INCLUDE_AUTODEFER_H_
+#define _INCLUDE_AUTODEFER_H_
+
+#include "extension.h"
+
+enum InteractionReply
+{
+	InteractionReply_None = 0,
+	InteractionReply_Deferred,
+	InteractionReply_Responded
+};
+
+// Upper bounds in milliseconds of the time to first response histogram, the last bucket is open ended
+static const int g_ResponseTimeBuckets[] = {100, 250, 500, 1000, 2000, 3000};
+#define RESPONSE_TIME_BUCKET_COUNT (sizeof(g_ResponseTimeBuckets) / sizeof(g_ResponseTimeBuckets[0]) + 1)
+
+/**
+ * @brief Reply state of one interaction, shared by its handle and the auto-deferrer.
+ */
+class InteractionState
+{
+private:
+	std::atomic<int> m_reply;
+	std::chrono::steady_clock::time_point m_receivedAt;
+
+public:
+	InteractionState() : m_reply(InteractionReply_None), m_receivedAt(std::chrono::steady_clock::now()) {}
+
+	/**
+	 * @brief Makes the first reply to the interaction. Safe to call from any thread.
+	 * 
+	 * @return False if the interaction was already replied to or deferred,
+	 *         later responses then have to edit the deferred one.
+	 */
+	bool Claim(InteractionReply reply);
+
+	InteractionReply GetReply() const { return static_cast<InteractionReply>(m_reply.load(std::memory_order_acquire)); }
+};
+
+/**
+ * @brief Defers interactions nobody replied to before Discord's deadline.
+ * 
+ * Slash commands can wait in the task queue or in a slow plugin for longer
+ * than the 3 seconds Discord allows for the first reply. A worker thread
+ * tracks every pending interaction and sends the deferred "thinking" reply
+ * itself once the configured delay passes. The interaction's later
+ * response is then sent as an edit. Off until a plugin sets a delay, as
+ * the deferral decides the visibility of that later response.
+ * 
+ * DPP's own timers tick in whole seconds, too coarse for this deadline.
+ */
+class AutoDeferrer
+{
+private:
+	struct Pending {
+		std::chrono::steady_clock::time_point deadline;
+		std::weak_ptr<InteractionState> state;
+		dpp::cluster* cluster;
+		dpp::snowflake id;
+		std::string token;
+		dpp::snowflake channelId;
+		dpp::snowflake guildId;
+
+		bool operator>(const Pending& other) const { return deadline > other.deadline; }
+	};
+
+	std::mutex m_mutex;
+	std::condition_variable m_cv;
+	std::priority_queue<Pending, std::vector<Pending>, std::greater<Pending>> m_pending;
+	std::thread m_thread;
+	bool m_shutdown;
+
+	std::atomic<int> m_delayMs;
+	std::atomic<bool> m_ephemeral;
+
+	std::atomic<uint64_t> m_autoDeferred;
+	std::atomic<uint64_t> m_responseTimes[RESPONSE_TIME_BUCKET_COUNT];
+
+	void Run();
+
+public:
+	AutoDeferrer();
+	~AutoDeferrer();
+
+	/**
+	 * @brief Starts tracking a new interaction. Safe to call from any thread.
+	 */
+	void Track(const std::shared_ptr<InteractionState>& state, dpp::cluster* cluster, const dpp::interaction& interaction);
+
+	/**
+	 * @brief Forgets every interaction of a cluster that is about to be destroyed.
+	 */
+	void RemoveCluster(const dpp::cluster* cluster);
+
+	/**
+	 * @brief Stops the worker thread, pending interactions are dropped.
+	 */
+	void Shutdown();
+
+	void RecordResponseTime(std::chrono::steady_clock::duration elapsed);
+
+	/**
+	 * @param delayMs Time after which unanswered interactions are deferred, 0 disables auto-deferral.
+	 * @param ephemeral Whether the deferred reply is only visible to the user.
+	 */
+	void SetDelay(int delayMs, bool ephemeral) {
+		m_delayMs.store(delayMs, std::memory_order_relaxed);
+		m_ephemeral.store(ephemeral, std::memory_order_relaxed);
+	}
+
+	uint64_t GetAutoDeferred() const { return m_autoDeferred.load(std::memory_order_relaxed); }
+	uint64_t GetResponseTimeBucket(size_t bucket) const { return m_responseTimes[bucket].load(std::memory_order_relaxed); }
+	void ResetStats();
+};
+
+extern AutoDeferrer g_AutoDeferrer;
+
+#endif // _INCLUDE_AUTODEFER_H_
@@ -0,0 +1,76 @@
+#include "extension.h"
+
+static std::string FoldCase(const std::string& str)
+{
+	std::string folded(str);
+	for (char& c : folded) {
+		if (c >= 'A' && c <= 'Z') {
+			c += 'a' - 'A';
+		}
+	}
+	return folded;
+}
+
+static bool IsSubsequence(const std::string& needle, const std::string& haystack)
+{
+	size_t pos = 0;
+	for (char c : haystack) {
+		if (pos < needle.length() && needle[pos] == c) {
+			pos++;
+		}
+	}
+	return pos == needle.length();
+}
+
+ChoiceIndex::ChoiceIndex(std::vector<AutocompleteChoice> choices) : m_choices(std::move(choices))
+{
+	for (AutocompleteChoice& choice : m_choices) {
+		choice.key = FoldCase(choice.name);
+	}
+
+	std::stable_sort(m_choices.begin(), m_choices.end(), [](const AutocompleteChoice& a, const AutocompleteChoice& b) {
+		return a.key < b.key;
+	});
+}
+
+void ChoiceIndex::Query(const std::string& input, size_t limit, std::vector<const AutocompleteChoice*>& out) const
+{
+	const std::string needle = FoldCase(input);
+
+	// Prefix matches are one contiguous run of the sorted keys
+	auto it = std::lower_bound(m_choices.begin(), m_choices.end(), needle, [](const AutocompleteChoice& choice, const std::string& value) {
+		return choice.key < value;
+	});
+	for (; it != m_choices.end() && out.size() < limit; ++it) {
+		if (it->key.compare(0, needle.length(), needle) != 0) {
+			break;
+		}
+		out.push_back(&*it);
+	}
+
+	if (out.size() >= limit || needle.empty()) {
+		return;
+	}
+
+	std::vector<const AutocompleteChoice*> fuzzy;
+	for (const AutocompleteChoice& choice : m_choices) {
+		if (out.size() >= limit) {
+			return;
+		}
+
+		if (choice.key.compare(0, needle.length(), needle) == 0) {
+			continue;
+		}
+
+		if (choice.key.find(needle) != std::string::npos) {
+			out.push_back(&choice);
+		}
+		else if (fuzzy.size() < limit && IsSubsequence(needle, choice.key)) {
+			fuzzy.push_back(&choice);
+		}
+	}
+
+	for (size_t i = 0; i < fuzzy.size() && out.size() < limit; i++) {
+		out.push_back(fuzzy[i]);
+	}
+}
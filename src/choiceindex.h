@@ -0,0 +1,51 @@
+#ifndef _INCLUDE_CHOICEINDEX_H_
+#define _INCLUDE_CHOICEINDEX_H_
+
+#include "extension.h"
+
+// Discord shows at most this many autocomplete choices
+#define MAX_AUTOCOMPLETE_CHOICES 25
+#define MAX_CHOICE_NAME_LENGTH 100
+
+struct AutocompleteChoice
+{
+	std::string name;
+	std::string key;	// name folded to lower case, filled in by ChoiceIndex
+	dpp::command_value value;
+};
+
+/**
+ * @brief Immutable, searchable set of autocomplete choices.
+ * 
+ * Built on the main thread and queried from DPP threads, so focused
+ * autocomplete requests are answered without waiting for a game frame.
+ * Choices whose name starts with the input rank first, then names that
+ * contain it, then names containing its characters in order. Matching is
+ * ASCII case-insensitive.
+ */
+class ChoiceIndex
+{
+private:
+	std::vector<AutocompleteChoice> m_choices;	// sorted by key
+
+public:
+	ChoiceIndex(std::vector<AutocompleteChoice> choices);
+
+	/**
+	 * @brief Finds the best matching choices for a partial input.
+	 * 
+	 * @param input What the user has typed so far.
+	 * @param limit Maximum number of choices to return.
+	 * @param[out] out Matching choices, best first.
+	 */
+	void Query(const std::string& input, size_t limit, std::vector<const AutocompleteChoice*>& out) const;
+
+	size_t GetCount() const { return m_choices.size(); }
+};
+
+/**
+ * @brief Choice indexes keyed by "<command path>:<option name>".
+ */
+typedef std::unordered_map<std::string, std::shared_ptr<const ChoiceIndex>> ChoiceIndexMap;
+
+#endif // _INCLUDE_CHOICEINDEX_H_
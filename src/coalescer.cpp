@@ -0,0 +1,112 @@
+#include "extension.h"
+
+// Counts UTF-8 characters, Discord's limit is not in bytes
+static size_t CountCharacters(const char* str, size_t bytes)
+{
+	size_t count = 0;
+	for (size_t i = 0; i < bytes; i++) {
+		if ((static_cast<unsigned char>(str[i]) & 0xC0) != 0x80) {
+			count++;
+		}
+	}
+	return count;
+}
+
+void MessageCoalescer::Emit(dpp::snowflake target, Buffer& buffer)
+{
+	if (buffer.content.empty()) {
+		return;
+	}
+
+	m_send(target, buffer.content, buffer.mentions);
+	buffer.content.clear();
+	buffer.length = 0;
+}
+
+void MessageCoalescer::SetWindow(dpp::snowflake target, int windowMs)
+{
+	auto it = m_buffers.find(target);
+	if (windowMs <= 0) {
+		if (it != m_buffers.end()) {
+			Emit(target, it->second);
+			m_buffers.erase(it);
+		}
+		return;
+	}
+
+	if (it == m_buffers.end()) {
+		m_buffers[target].windowMs = windowMs;
+	}
+	else {
+		it->second.windowMs = windowMs;
+	}
+}
+
+bool MessageCoalescer::Add(dpp::snowflake target, const char* content, AllowedMentions mentions)
+{
+	auto it = m_buffers.find(target);
+	if (it == m_buffers.end()) {
+		return false;
+	}
+
+	Buffer& buffer = it->second;
+	if (!buffer.content.empty() && !(buffer.mentions == mentions)) {
+		Emit(target, buffer);
+	}
+
+	if (buffer.content.empty()) {
+		buffer.mentions = std::move(mentions);
+	}
+
+	const char* line = content;
+	while (*line) {
+		const char* end = strchr(line, '\n');
+		const size_t bytes = end ? static_cast<size_t>(end - line) : strlen(line);
+		const size_t length = CountCharacters(line, bytes);
+
+		if (!buffer.content.empty() && buffer.length + 1 + length > MAX_MESSAGE_LENGTH) {
+			Emit(target, buffer);
+		}
+
+		// The window starts with the first line held, also after a full message was sent mid-call
+		if (buffer.content.empty()) {
+			buffer.deadline = coalesce_clock::now() + std::chrono::milliseconds(buffer.windowMs);
+		}
+		else {
+			buffer.content += '\n';
+			buffer.length++;
+		}
+		buffer.content.append(line, bytes);
+		buffer.length += length;
+
+		if (!end) {
+			break;
+		}
+		line = end + 1;
+	}
+
+	// Nothing more fits, no need to wait for the window
+	if (buffer.length >= MAX_MESSAGE_LENGTH) {
+		Emit(target, buffer);
+	}
+
+	return true;
+}
+
+void MessageCoalescer::Flush(bool force)
+{
+	const coalesce_clock::time_point now = coalesce_clock::now();
+	for (auto& entry : m_buffers) {
+		if (!entry.second.content.empty() && (force || entry.second.deadline <= now)) {
+			Emit(entry.first, entry.second);
+		}
+	}
+}
+
+void MessageCoalescer::FlushTarget(dpp::snowflake target)
+{
+	auto it = m_buffers.find(target);
+	if (it != m_buffers.end()) {
+		Emit(target, it->second);
+	}
+}
@@ -0,0 +1,84 @@
+#ifndef _INCLUDE_COALESCER_H_
+#define _INCLUDE_COALESCER_H_
+
+#include "extension.h"
+
+// Discord rejects message content longer than this many characters
+#define MAX_MESSAGE_LENGTH 2000
+
+// How long stopping a client waits for the last coalesced messages to be delivered
+#define COALESCE_STOP_TIMEOUT_MS 5000
+
+struct AllowedMentions
+{
+	int mask;
+	std::vector<dpp::snowflake> users;
+	std::vector<dpp::snowflake> roles;
+
+	bool operator==(const AllowedMentions& other) const {
+		return mask == other.mask && users == other.users && roles == other.roles;
+	}
+};
+
+/**
+ * @brief Merges short messages sent to the same channel or webhook.
+ *
+ * Lines are buffered per target for a configurable window, counted from
+ * the first buffered line, then sent as few messages as possible under
+ * MAX_MESSAGE_LENGTH. Messages are only split at line boundaries; a single
+ * line that is too long is sent on its own. Lines with different allowed
+ * mentions are never merged. Main thread only.
+ */
+class MessageCoalescer
+{
+public:
+	typedef std::function<void(dpp::snowflake target, const std::string& content, const AllowedMentions& mentions)> SendCallback;
+
+private:
+	typedef std::chrono::steady_clock coalesce_clock;
+
+	struct Buffer
+	{
+		int windowMs;
+		coalesce_clock::time_point deadline;
+		std::string content;
+		size_t length = 0;		// in characters, not bytes
+		AllowedMentions mentions;
+	};
+
+	std::unordered_map<dpp::snowflake, Buffer> m_buffers;
+	SendCallback m_send;
+
+	void Emit(dpp::snowflake target, Buffer& buffer);
+
+public:
+	MessageCoalescer(SendCallback send) : m_send(std::move(send)) {}
+
+	/**
+	 * @brief Enables coalescing for a target, or disables it if windowMs is 0.
+	 *
+	 * Disabling sends whatever is still buffered.
+	 */
+	void SetWindow(dpp::snowflake target, int windowMs);
+
+	bool IsEnabled(dpp::snowflake target) const { return m_buffers.find(target) != m_buffers.end(); }
+
+	/**
+	 * @brief Buffers content for a target.
+	 *
+	 * @return false if coalescing is not enabled for the target.
+	 */
+	bool Add(dpp::snowflake target, const char* content, AllowedMentions mentions);
+
+	/**
+	 * @brief Sends the buffers whose window has passed, or all of them if force is set.
+	 */
+	void Flush(bool force = false);
+
+	/**
+	 * @brief Sends what is buffered for one target right away.
+	 */
+	void FlushTarget(dpp::snowflake target);
+};
+
+#endif // _INCLUDE_COALESCER_H_
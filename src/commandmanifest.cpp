@@ -0,0 +1,303 @@
+#include "extension.h"
+
+static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+static void HashBytes(uint64_t& hash, const void* data, size_t size)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	for (size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= FNV_PRIME;
+	}
+}
+
+// Includes the terminator so "ab" + "c" and "a" + "bc" hash differently
+static void HashString(uint64_t& hash, const std::string& str)
+{
+	HashBytes(hash, str.c_str(), str.size() + 1);
+}
+
+static void HashValue(uint64_t& hash, uint64_t value)
+{
+	HashBytes(hash, &value, sizeof(value));
+}
+
+static void HashOptions(uint64_t& hash, const std::vector<dpp::command_option>& options)
+{
+	HashValue(hash, options.size());
+	for (const dpp::command_option& option : options) {
+		HashValue(hash, option.type);
+		HashString(hash, option.name);
+		HashString(hash, option.description);
+		HashValue(hash, option.required);
+		HashValue(hash, option.autocomplete);
+		HashOptions(hash, option.options);
+	}
+}
+
+uint64_t CommandManifest::HashCommand(const dpp::slashcommand& command)
+{
+	uint64_t hash = FNV_OFFSET_BASIS;
+	HashValue(hash, command.type);
+	HashString(hash, command.name);
+	HashString(hash, command.description);
+	HashValue(hash, command.default_member_permissions);
+	HashOptions(hash, command.options);
+	return hash;
+}
+
+CommandSyncResult CommandManifest::Diff(const std::vector<dpp::slashcommand>& wanted, const dpp::slashcommand_map& current)
+{
+	std::unordered_map<std::string, uint64_t> currentHashes;
+	for (const auto& entry : current) {
+		currentHashes[entry.second.name] = HashCommand(entry.second);
+	}
+
+	CommandSyncResult result;
+	for (const dpp::slashcommand& command : wanted) {
+		auto it = currentHashes.find(command.name);
+		if (it == currentHashes.end()) {
+			result.created++;
+			continue;
+		}
+
+		if (it->second == HashCommand(command)) {
+			result.unchanged++;
+		}
+		else {
+			result.changed++;
+		}
+		currentHashes.erase(it);
+	}
+	result.removed = static_cast<int>(currentHashes.size());
+
+	return result;
+}
+
+CommandManifest::CommandIdMap CommandManifest::GetIds(const dpp::slashcommand_map& commands)
+{
+	CommandIdMap ids;
+	for (const auto& entry : commands) {
+		ids[entry.second.name] = entry.first;
+	}
+	return ids;
+}
+
+void CommandManifest::Enable(int settleMs)
+{
+	m_enabled = true;
+	m_settleMs = settleMs;
+}
+
+void CommandManifest::Add(dpp::snowflake scope, const dpp::slashcommand& command)
+{
+	Scope& target = m_scopes[scope];
+	target.commands[command.name] = Entry{command, HashCommand(command)};
+	target.dirty = true;
+	target.settleAt = manifest_clock::now() + std::chrono::milliseconds(m_settleMs);
+	target.generation++;
+}
+
+bool CommandManifest::Remove(dpp::snowflake scope, dpp::snowflake command_id)
+{
+	auto it = m_scopes.find(scope);
+	if (it == m_scopes.end()) {
+		return false;
+	}
+
+	for (auto synced = it->second.synced.begin(); synced != it->second.synced.end(); ++synced) {
+		if (synced->second.id == command_id) {
+			it->second.commands.erase(synced->first);
+			it->second.synced.erase(synced);
+			// Discord no longer has the synced set, registering the command again has to recreate it
+			it->second.syncedHash = 0;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool CommandManifest::Clear(dpp::snowflake scope)
+{
+	auto it = m_scopes.find(scope);
+	if (it == m_scopes.end()) {
+		return false;
+	}
+
+	it->second.commands.clear();
+	it->second.synced.clear();
+	it->second.dirty = false;
+	it->second.syncedHash = 0;
+	return true;
+}
+
+dpp::snowflake CommandManifest::FindId(dpp::snowflake scope, const std::string& name) const
+{
+	auto it = m_scopes.find(scope);
+	if (it == m_scopes.end()) {
+		return 0;
+	}
+
+	auto synced = it->second.synced.find(name);
+	return synced != it->second.synced.end() ? synced->second.id : dpp::snowflake(0);
+}
+
+uint64_t CommandManifest::GetHash(dpp::snowflake scope) const
+{
+	uint64_t hash = FNV_OFFSET_BASIS;
+	auto it = m_scopes.find(scope);
+	if (it != m_scopes.end()) {
+		for (const auto& entry : it->second.commands) {
+			HashValue(hash, entry.second.hash);
+		}
+	}
+	return hash;
+}
+
+uint64_t CommandManifest::GetSyncedHash(dpp::snowflake scope) const
+{
+	auto it = m_scopes.find(scope);
+	return it != m_scopes.end() ? it->second.syncedHash : 0;
+}
+
+std::vector<dpp::slashcommand> CommandManifest::GetCommands(dpp::snowflake scope) const
+{
+	std::vector<dpp::slashcommand> commands;
+	auto it = m_scopes.find(scope);
+	if (it != m_scopes.end()) {
+		commands.reserve(it->second.commands.size());
+		for (const auto& entry : it->second.commands) {
+			commands.push_back(entry.second.command);
+		}
+	}
+	return commands;
+}
+
+std::vector<dpp::snowflake> CommandManifest::TakeDue(bool force)
+{
+	std::vector<dpp::snowflake> due;
+	if (!force && m_settleMs <= 0) {
+		return due;
+	}
+
+	const manifest_clock::time_point now = manifest_clock::now();
+	for (auto& entry : m_scopes) {
+		Scope& scope = entry.second;
+		if (scope.dirty && !scope.syncing && (force || scope.settleAt <= now)) {
+			scope.dirty = false;
+			scope.syncing = true;
+			scope.syncGeneration = scope.generation;
+			due.push_back(entry.first);
+		}
+	}
+	return due;
+}
+
+void CommandManifest::OnSynced(dpp::snowflake scope, bool success, uint64_t hash, std::optional<CommandIdMap> ids)
+{
+	Scope& target = m_scopes[scope];
+	target.syncing = false;
+
+	if (!success) {
+		// Retried on the next registration or sync request, not in a loop against a failing endpoint.
+		// A registration made during the sync already set its own deadline, which is kept.
+		target.dirty = true;
+		if (target.generation == target.syncGeneration) {
+			target.settleAt = manifest_clock::time_point::max();
+		}
+		return;
+	}
+
+	target.syncedHash = hash;
+	if (!ids) {
+		return;
+	}
+
+	target.synced.clear();
+	for (const auto& id : *ids) {
+		auto entry = target.commands.find(id.first);
+		target.synced[id.first] = SyncedCommand{id.second, entry != target.commands.end() ? entry->second.hash : 0};
+	}
+}
+
+bool CommandManifest::Load(const char* path, dpp::snowflake application_id)
+{
+	try {
+		std::ifstream file(path);
+		dpp::json cache = dpp::json::parse(file);
+
+		if (std::stoull(cache.at("application_id").get<std::string>()) != application_id) {
+			return false;
+		}
+
+		for (const dpp::json& saved : cache.at("scopes")) {
+			Scope& scope = m_scopes[std::stoull(saved.at("guild_id").get<std::string>())];
+			if (scope.syncedHash) {
+				continue;
+			}
+
+			scope.syncedHash = std::stoull(saved.at("hash").get<std::string>());
+			for (const dpp::json& command : saved.at("commands")) {
+				scope.synced[command.at("name").get<std::string>()] = SyncedCommand{
+					std::stoull(command.at("id").get<std::string>()),
+					std::stoull(command.at("hash").get<std::string>())
+				};
+			}
+		}
+		return true;
+	}
+	catch (const std::exception&) {
+		return false;
+	}
+}
+
+bool CommandManifest::Save(const char* path, dpp::snowflake application_id) const
+{
+	// 64-bit values are written as strings, JSON readers commonly lose precision above 2^53
+	dpp::json scopes = dpp::json::array();
+	for (const auto& entry : m_scopes) {
+		// A scope whose hash was reset still has to keep its IDs for lookups by name
+		const Scope& scope = entry.second;
+		if (!scope.syncedHash && scope.synced.empty()) {
+			continue;
+		}
+
+		dpp::json commands = dpp::json::array();
+		for (const auto& synced : scope.synced) {
+			commands.push_back({
+				{"name", synced.first},
+				{"id", std::to_string(synced.second.id)},
+				{"hash", std::to_string(synced.second.hash)}
+			});
+		}
+
+		scopes.push_back({
+			{"guild_id", std::to_string(entry.first)},
+			{"hash", std::to_string(scope.syncedHash)},
+			{"commands", std::move(commands)}
+		});
+	}
+
+	dpp::json cache = {
+		{"application_id", std::to_string(application_id)},
+		{"scopes", std::move(scopes)}
+	};
+
+	const std::string temp = std::string(path) + ".tmp";
+	{
+		std::ofstream file(temp, std::ios::trunc);
+		file << cache.dump(1, '\t');
+		if (!file) {
+			return false;
+		}
+	}
+
+	if (std::rename(temp.c_str(), path) == 0) {
+		return true;
+	}
+
+	// Windows does not replace an existing file
+	std::remove(path);
+	return std::rename(temp.c_str(), path) == 0;
+}
@@ -0,0 +1,139 @@
+#ifndef _INCLUDE_COMMANDMANIFEST_H_
+#define _INCLUDE_COMMANDMANIFEST_H_
+
+#include "extension.h"
+
+#define DEFAULT_MANIFEST_SETTLE_MS 1000
+
+struct CommandSyncResult
+{
+	int created = 0;
+	int changed = 0;
+	int unchanged = 0;
+	int removed = 0;
+
+	bool IsUnchanged() const { return !created && !changed && !removed; }
+};
+
+/**
+ * @brief Wanted set of application commands, per guild and globally.
+ *
+ * Registrations only replace the entry with the same name. A scope is
+ * synced once no registration touched it for the settle time: if its
+ * hash still matches the set last confirmed on Discord nothing is sent,
+ * otherwise the current commands are fetched once and a single bulk
+ * overwrite is issued if they differ. The manifest owns every scope it
+ * syncs, commands missing from it are removed by the overwrite. What
+ * was synced can be saved and loaded again, so a restart with the same
+ * commands needs no request at all. Main thread only.
+ */
+class CommandManifest
+{
+public:
+	typedef std::unordered_map<std::string, dpp::snowflake> CommandIdMap;
+
+private:
+	typedef std::chrono::steady_clock manifest_clock;
+
+	struct SyncedCommand
+	{
+		dpp::snowflake id;
+		uint64_t hash;
+	};
+
+	struct Entry
+	{
+		dpp::slashcommand command;
+		uint64_t hash;
+	};
+
+	struct Scope
+	{
+		std::map<std::string, Entry> commands;		// ordered, so the scope hash does not depend on registration order
+		bool dirty = false;
+		bool syncing = false;
+		manifest_clock::time_point settleAt;
+		uint32_t generation = 0;					// bumped by every registration
+		uint32_t syncGeneration = 0;				// generation the running sync was started with
+		uint64_t syncedHash = 0;					// hash of the set last confirmed on Discord, 0 if unknown
+		std::map<std::string, SyncedCommand> synced;	// by name, as confirmed by the last sync
+	};
+
+	std::unordered_map<dpp::snowflake, Scope> m_scopes;		// 0 holds the global commands
+	bool m_enabled = false;
+	int m_settleMs = DEFAULT_MANIFEST_SETTLE_MS;
+
+public:
+	/**
+	 * @brief 64-bit FNV-1a over the fields a registration can set.
+	 */
+	static uint64_t HashCommand(const dpp::slashcommand& command);
+
+	/**
+	 * @brief Counts what a bulk overwrite with wanted would do to current.
+	 */
+	static CommandSyncResult Diff(const std::vector<dpp::slashcommand>& wanted, const dpp::slashcommand_map& current);
+
+	static CommandIdMap GetIds(const dpp::slashcommand_map& commands);
+
+	/**
+	 * @brief Collects registrations from now on. With settleMs 0 scopes are only synced on request.
+	 */
+	void Enable(int settleMs);
+	bool IsEnabled() const { return m_enabled; }
+
+	void Add(dpp::snowflake scope, const dpp::slashcommand& command);
+
+	/**
+	 * @brief Forgets a command deleted outside the manifest, so the next sync does not recreate it.
+	 *
+	 * The scope's next sync fetches the commands again.
+	 *
+	 * @return true if the command was known, the saved state is then out of date.
+	 */
+	bool Remove(dpp::snowflake scope, dpp::snowflake command_id);
+
+	/**
+	 * @brief Forgets every command of a scope.
+	 *
+	 * @return true if anything was known about the scope.
+	 */
+	bool Clear(dpp::snowflake scope);
+
+	/**
+	 * @brief Looks up the ID Discord gave a synced command.
+	 *
+	 * @return ID of the command, or 0 if no command of that name was synced.
+	 */
+	dpp::snowflake FindId(dpp::snowflake scope, const std::string& name) const;
+
+	uint64_t GetHash(dpp::snowflake scope) const;
+	uint64_t GetSyncedHash(dpp::snowflake scope) const;
+	std::vector<dpp::slashcommand> GetCommands(dpp::snowflake scope) const;
+
+	/**
+	 * @brief Picks the scopes that are due for a sync, or every changed one if force is set.
+	 *
+	 * The picked scopes are marked as syncing until OnSynced is called.
+	 */
+	std::vector<dpp::snowflake> TakeDue(bool force);
+
+	/**
+	 * @brief Ends a sync. On success the scope's hash and, if given, command IDs are remembered.
+	 */
+	void OnSynced(dpp::snowflake scope, bool success, uint64_t hash, std::optional<CommandIdMap> ids = std::nullopt);
+
+	/**
+	 * @brief Restores what earlier runs synced, for scopes not synced since.
+	 *
+	 * @return false if the file cannot be parsed or belongs to another application.
+	 */
+	bool Load(const char* path, dpp::snowflake application_id);
+
+	/**
+	 * @brief Writes what was synced, replacing the file only once it is complete.
+	 */
+	bool Save(const char* path, dpp::snowflake application_id) const;
+};
+
+#endif // _INCLUDE_COMMANDMANIFEST_H_
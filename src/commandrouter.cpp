@@ -0,0 +1,129 @@
+#include "extension.h"
+
+CommandRouter g_CommandRouter;
+
+CommandRouter::CommandRouter() : m_routeCount(0)
+{
+}
+
+std::string CommandRouter::GetCommandPath(const dpp::interaction& interaction)
+{
+	const dpp::command_interaction* command = std::get_if<dpp::command_interaction>(&interaction.data);
+	if (!command) {
+		return std::string();
+	}
+
+	std::string path = command->name;
+
+	// Subcommand groups and subcommands are always the first, and only, option of their parent
+	const std::vector<dpp::command_data_option>* options = &command->options;
+	while (!options->empty()) {
+		const dpp::command_data_option& option = options->front();
+		if (option.type != dpp::co_sub_command_group && option.type != dpp::co_sub_command) {
+			break;
+		}
+
+		path += ' ';
+		path += option.name;
+		options = &option.options;
+	}
+
+	return path;
+}
+
+bool CommandRouter::Register(const DiscordClient* client, const std::string& path, IPluginFunction* callback, IPluginRuntime* owner, cell_t data)
+{
+	RouteMap& routes = m_routes[client];
+
+	auto it = routes.find(path);
+	if (it != routes.end() && it->second.owner != owner) {
+		return false;
+	}
+
+	routes[path] = Route{callback, owner, data};
+	UpdateRouteCount();
+	return true;
+}
+
+bool CommandRouter::Unregister(const DiscordClient* client, const std::string& path, IPluginRuntime* owner)
+{
+	auto clientIt = m_routes.find(client);
+	if (clientIt == m_routes.end()) {
+		return false;
+	}
+
+	auto it = clientIt->second.find(path);
+	if (it == clientIt->second.end() || it->second.owner != owner) {
+		return false;
+	}
+
+	clientIt->second.erase(it);
+	UpdateRouteCount();
+	return true;
+}
+
+bool CommandRouter::Dispatch(const DiscordClient* client, Handle_t discord, const std::string& path, Handle_t interaction)
+{
+	auto clientIt = m_routes.find(client);
+	if (clientIt == m_routes.end()) {
+		return false;
+	}
+
+	const RouteMap& routes = clientIt->second;
+	size_t length = path.length();
+	while (true) {
+		auto it = routes.find(path.substr(0, length));
+		if (it != routes.end()) {
+			// Copied, the callback may change the routes
+			Route route = it->second;
+			route.callback->PushCell(discord);
+			route.callback->PushCell(interaction);
+			route.callback->PushCell(route.data);
+			route.callback->Execute(nullptr);
+			return true;
+		}
+
+		if (length == 0) {
+			return false;
+		}
+
+		size_t separator = path.rfind(' ', length - 1);
+		if (separator == std::string::npos) {
+			return false;
+		}
+		length = separator;
+	}
+}
+
+void CommandRouter::RemoveClient(const DiscordClient* client)
+{
+	m_routes.erase(client);
+	UpdateRouteCount();
+}
+
+void CommandRouter::RemovePlugin(IPluginRuntime* owner)
+{
+	for (auto& client : m_routes) {
+		RouteMap& routes = client.second;
+		for (auto it = routes.begin(); it != routes.end(); ) {
+			if (it->second.owner == owner) {
+				it = routes.erase(it);
+			}
+			else {
+				++it;
+			}
+		}
+	}
+
+	UpdateRouteCount();
+}
+
+void CommandRouter::UpdateRouteCount()
+{
+	size_t count = 0;
+	for (const auto& client : m_routes) {
+		count += client.second.size();
+	}
+
+	m_routeCount.store(count, std::memory_order_relaxed);
+}
@@ -0,0 +1,72 @@
+#ifndef _INCLUDE_COMMANDROUTER_H_
+#define _INCLUDE_COMMANDROUTER_H_
+
+#include "extension.h"
+
+class DiscordClient;
+
+/**
+ * @brief Routes slash commands straight to the plugin function that owns them.
+ * 
+ * Routes are keyed by client and command path, the command name followed
+ * by its subcommand group and subcommand separated by spaces, e.g.
+ * "admin ban" or "admin users kick". The longest registered prefix of an
+ * interaction's path wins. Only touched on the main thread.
+ */
+class CommandRouter
+{
+private:
+	struct Route {
+		IPluginFunction* callback;
+		IPluginRuntime* owner;
+		cell_t data;
+	};
+
+	typedef std::unordered_map<std::string, Route> RouteMap;
+
+	std::unordered_map<const DiscordClient*, RouteMap> m_routes;
+	std::atomic<size_t> m_routeCount;
+
+	void UpdateRouteCount();
+
+public:
+	CommandRouter();
+
+	/**
+	 * @brief Builds the command path of an interaction.
+	 */
+	static std::string GetCommandPath(const dpp::interaction& interaction);
+
+	/**
+	 * @brief Routes a command path to a plugin function.
+	 * 
+	 * @return False if another plugin already owns the path.
+	 */
+	bool Register(const DiscordClient* client, const std::string& path, IPluginFunction* callback, IPluginRuntime* owner, cell_t data);
+
+	/**
+	 * @brief Removes a route owned by the given plugin.
+	 * 
+	 * @return False if the path has no route owned by the plugin.
+	 */
+	bool Unregister(const DiscordClient* client, const std::string& path, IPluginRuntime* owner);
+
+	/**
+	 * @brief Calls the function owning the longest matching prefix of a path.
+	 * 
+	 * @return False if no route matched and nothing was called.
+	 */
+	bool Dispatch(const DiscordClient* client, Handle_t discord, const std::string& path, Handle_t interaction);
+
+	void RemoveClient(const DiscordClient* client);
+	void RemovePlugin(IPluginRuntime* owner);
+
+	/**
+	 * @brief Checks if any route exists. Safe to call from any thread.
+	 */
+	bool HasRoutes() const { return m_routeCount.load(std::memory_order_relaxed) > 0; }
+};
+
+extern CommandRouter g_CommandRouter;
+
+#endif // _INCLUDE_COMMANDROUTER_H_
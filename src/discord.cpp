@@ -1,13 +1,18 @@
 #include "extension.h"
 
 // Discord Client Implementation
-DiscordClient::DiscordClient(const char* token) : m_isRunning(false), m_discord_handle(0)
+DiscordClient::DiscordClient(const char* token) : m_isRunning(false), m_discord_handle(0), m_filterPassed(0), m_filterDropped(0),
+	m_channelCoalescer([this](dpp::snowflake id, const std::string& content, const AllowedMentions& mentions) { SendCoalescedMessage(id, content, mentions); }),
+	m_webhookCoalescer([this](dpp::snowflake id, const std::string& content, const AllowedMentions& mentions) { SendCoalescedWebhook(id, content, mentions); })
 {
-	m_cluster = std::make_unique<dpp::cluster>(token, dpp::i_default_intents | dpp::i_message_content);
+	m_cluster = std::make_shared<dpp::cluster>(token, dpp::i_default_intents | dpp::i_message_content);
+	g_Dispatcher.AddListener(this);
 }
 
 DiscordClient::~DiscordClient()
 {
+	g_Dispatcher.RemoveListener(this);
+	g_CommandRouter.RemoveClient(this);
 	Stop();
 }
 
@@ -50,6 +55,11 @@ void DiscordClient::Stop()
 		return;
 	}
 
+	// The REST queue dies with the cluster, so buffered lines have to be delivered first
+	FlushCoalesced();
+	if (!WaitForCoalescedSends(std::chrono::milliseconds(COALESCE_STOP_TIMEOUT_MS))) {
+		smutils->LogError(myself, "Coalesced messages were still being sent after %d ms and are dropped", COALESCE_STOP_TIMEOUT_MS);
+	}
 	m_isRunning = false;
 
 	try {
@@ -63,6 +73,8 @@ void DiscordClient::Stop()
 
 		m_thread.reset();
 
+		// Pending auto-defers hold the raw cluster pointer
+		g_AutoDeferrer.RemoveCluster(m_cluster.get());
 		m_cluster.reset();
 
 		smutils->LogMessage(myself, "Discord bot stopped successfully");
@@ -93,59 +105,233 @@ void AddAllowedMentionsToMessage(dpp::message* msg, int allowed_mentions_mask, s
 	msg->set_allowed_mentions(allowed_mentions_mask & 1, allowed_mentions_mask & 2, allowed_mentions_mask & 4, allowed_mentions_mask & 8, users, roles);
 }
 
-bool DiscordClient::ExecuteWebhook(dpp::webhook wh, const char* message, int allowed_mentions_mask, std::vector<dpp::snowflake> users, std::vector<dpp::snowflake> roles)
+dpp::command_completion_event_t DiscordClient::MakeSendCallback(IChangeableForward* callback_forward, cell_t data)
+{
+	if (!callback_forward) {
+		return dpp::utility::log_error();
+	}
+
+	return [this, forward = callback_forward, data](const dpp::confirmation_callback_t& callback) {
+		const bool success = !callback.is_error();
+		std::string messageId;
+		std::string error;
+
+		if (success) {
+			if (const dpp::message* msg = std::get_if<dpp::message>(&callback.value)) {
+				messageId = std::to_string(msg->id);
+			}
+		}
+		else {
+			error = callback.get_error().message;
+			if (error.empty()) {
+				error = "HTTP " + std::to_string(callback.http_info.status);
+			}
+		}
+
+		g_TaskQueue.Push([this, forward, data, success, messageId = std::move(messageId), error = std::move(error),
+			status = callback.http_info.status, retryAfter = callback.http_info.ratelimit_retry_after]() {
+			if (forward->GetFunctionCount()) {
+				forward->PushCell(m_discord_handle);
+				forward->PushCell(success ? 1 : 0);
+				forward->PushString(messageId.c_str());
+				forward->PushString(error.c_str());
+				forward->PushCell(status);
+				forward->PushCell(static_cast<cell_t>(retryAfter));
+				forward->PushCell(data);
+				forward->Execute(nullptr);
+			}
+
+			forwards->ReleaseForward(forward);
+		}, TaskLane_Message);
+	};
+}
+
+bool DiscordClient::ExecuteWebhook(dpp::webhook wh, const char* message, int allowed_mentions_mask, std::vector<dpp::snowflake> users, std::vector<dpp::snowflake> roles, IChangeableForward* callback_forward, cell_t data)
 {
 	if (!m_isRunning) {
+		if (callback_forward) {
+			forwards->ReleaseForward(callback_forward);
+		}
 		return false;
 	}
 
+	if (m_webhookCoalescer.IsEnabled(wh.id)) {
+		m_coalescedWebhooks[wh.id] = wh;
+
+		// A caller waiting for the message ID gets its own message, sent after what is already held
+		if (!callback_forward) {
+			return m_webhookCoalescer.Add(wh.id, message, AllowedMentions{allowed_mentions_mask, std::move(users), std::move(roles)});
+		}
+		m_webhookCoalescer.FlushTarget(wh.id);
+	}
+
 	dpp::message message_obj(message);
 	AddAllowedMentionsToMessage(&message_obj, allowed_mentions_mask, users, roles);
 
 	try {
-		m_cluster->execute_webhook(wh, message_obj);
+		// Discord only returns the created message when asked to wait for it
+		m_cluster->execute_webhook(wh, message_obj, callback_forward != nullptr, 0, "", MakeSendCallback(callback_forward, data));
 		return true;
 	}
 	catch (const std::exception& e) {
+		if (callback_forward) {
+			forwards->ReleaseForward(callback_forward);
+		}
 		smutils->LogError(myself, "Failed to execute webhook: %s", e.what());
 		return false;
 	}
 }
 
-bool DiscordClient::SendMessage(dpp::snowflake channel_id, const char* message, int allowed_mentions_mask, std::vector<dpp::snowflake> users, std::vector<dpp::snowflake> roles)
+bool DiscordClient::SendMessage(dpp::snowflake channel_id, const char* message, int allowed_mentions_mask, std::vector<dpp::snowflake> users, std::vector<dpp::snowflake> roles, IChangeableForward* callback_forward, cell_t data)
 {
 	if (!m_isRunning) {
+		if (callback_forward) {
+			forwards->ReleaseForward(callback_forward);
+		}
 		return false;
 	}
 
+	if (m_channelCoalescer.IsEnabled(channel_id)) {
+		// A caller waiting for the message ID gets its own message, sent after what is already held
+		if (!callback_forward) {
+			return m_channelCoalescer.Add(channel_id, message, AllowedMentions{allowed_mentions_mask, std::move(users), std::move(roles)});
+		}
+		m_channelCoalescer.FlushTarget(channel_id);
+	}
+
 	dpp::message message_obj(channel_id, message);
 	AddAllowedMentionsToMessage(&message_obj, allowed_mentions_mask, users, roles);
 
 	try {
-		m_cluster->message_create(message_obj);
+		m_cluster->message_create(message_obj, MakeSendCallback(callback_forward, data));
 		return true;
 	}
 	catch (const std::exception& e) {
+		if (callback_forward) {
+			forwards->ReleaseForward(callback_forward);
+		}
 		smutils->LogError(myself, "Failed to send message: %s", e.what());
 		return false;
 	}
 }
 
-bool DiscordClient::SendMessageEmbed(dpp::snowflake channel_id, const char* message, const DiscordEmbed* embed, int allowed_mentions_mask, std::vector<dpp::snowflake> users, std::vector<dpp::snowflake> roles)
+void DiscordClient::SendCoalescedMessage(dpp::snowflake channel_id, const std::string& content, const AllowedMentions& mentions)
+{
+	dpp::message message_obj(channel_id, content);
+	AddAllowedMentionsToMessage(&message_obj, mentions.mask, mentions.users, mentions.roles);
+
+	try {
+		m_cluster->message_create(message_obj, TrackCoalescedSend());
+	}
+	catch (const std::exception& e) {
+		OnCoalescedSendDone();
+		smutils->LogError(myself, "Failed to send message: %s", e.what());
+	}
+}
+
+void DiscordClient::SendCoalescedWebhook(dpp::snowflake webhook_id, const std::string& content, const AllowedMentions& mentions)
+{
+	auto it = m_coalescedWebhooks.find(webhook_id);
+	if (it == m_coalescedWebhooks.end()) {
+		return;
+	}
+
+	dpp::message message_obj(content);
+	AddAllowedMentionsToMessage(&message_obj, mentions.mask, mentions.users, mentions.roles);
+
+	try {
+		m_cluster->execute_webhook(it->second, message_obj, false, 0, "", TrackCoalescedSend());
+	}
+	catch (const std::exception& e) {
+		OnCoalescedSendDone();
+		smutils->LogError(myself, "Failed to execute webhook: %s", e.what());
+	}
+}
+
+dpp::command_completion_event_t DiscordClient::TrackCoalescedSend()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_coalescedMutex);
+		m_coalescedInFlight++;
+	}
+
+	return [this](const dpp::confirmation_callback_t& callback) {
+		if (callback.is_error()) {
+			smutils->LogError(myself, "Failed to send coalesced message: %s", callback.get_error().message.c_str());
+		}
+		OnCoalescedSendDone();
+	};
+}
+
+void DiscordClient::OnCoalescedSendDone()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_coalescedMutex);
+		m_coalescedInFlight--;
+	}
+	m_coalescedDone.notify_all();
+}
+
+bool DiscordClient::WaitForCoalescedSends(std::chrono::milliseconds timeout)
+{
+	std::unique_lock<std::mutex> lock(m_coalescedMutex);
+	return m_coalescedDone.wait_for(lock, timeout, [this]() { return m_coalescedInFlight == 0; });
+}
+
+void DiscordClient::SetChannelCoalescing(dpp::snowflake channel_id, int windowMs)
+{
+	m_channelCoalescer.SetWindow(channel_id, windowMs);
+}
+
+void DiscordClient::SetWebhookCoalescing(const dpp::webhook& wh, int windowMs)
+{
+	if (windowMs > 0) {
+		m_coalescedWebhooks[wh.id] = wh;
+	}
+
+	m_webhookCoalescer.SetWindow(wh.id, windowMs);
+
+	if (windowMs <= 0) {
+		m_coalescedWebhooks.erase(wh.id);
+	}
+}
+
+void DiscordClient::FlushCoalesced(bool force)
+{
+	if (!m_isRunning) {
+		return;
+	}
+
+	m_channelCoalescer.Flush(force);
+	m_webhookCoalescer.Flush(force);
+}
+
+bool DiscordClient::SendMessageEmbed(dpp::snowflake channel_id, const char* message, const DiscordEmbed* embed, int allowed_mentions_mask, std::vector<dpp::snowflake> users, std::vector<dpp::snowflake> roles, IChangeableForward* callback_forward, cell_t data)
 {
 	if (!m_isRunning) {
+		if (callback_forward) {
+			forwards->ReleaseForward(callback_forward);
+		}
 		return false;
 	}
 
+	// Embeds are never merged, but must not overtake text already held for the channel
+	if (m_channelCoalescer.IsEnabled(channel_id)) {
+		m_channelCoalescer.FlushTarget(channel_id);
+	}
+
 	dpp::message message_obj(channel_id, message);
 	AddAllowedMentionsToMessage(&message_obj, allowed_mentions_mask, users, roles);
 
 	try {
 		message_obj.add_embed(embed->GetEmbed());
-		m_cluster->message_create(message_obj);
+		m_cluster->message_create(message_obj, MakeSendCallback(callback_forward, data));
 		return true;
 	}
 	catch (const std::exception& e) {
+		if (callback_forward) {
+			forwards->ReleaseForward(callback_forward);
+		}
 		smutils->LogError(myself, "Failed to send message with embed: %s", e.what());
 		return false;
 	}
@@ -314,6 +500,213 @@ bool DiscordClient::GetChannel(dpp::snowflake channel_id, IForward *callback_for
 	}
 }
 
+bool DiscordClient::PassesMessageFilter(const dpp::message& msg)
+{
+	std::shared_ptr<const MessageFilter> filter = std::atomic_load(&m_messageFilter);
+	if (!filter) {
+		return true;
+	}
+
+	if (!filter->Matches(msg)) {
+		m_filterDropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	m_filterPassed.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+MessageSnapshot::MessageSnapshot(const dpp::message& msg) :
+	m_contentLength(static_cast<uint32_t>(msg.content.length())),
+	m_id(msg.id),
+	m_channelId(msg.channel_id),
+	m_guildId(msg.guild_id),
+	m_authorId(msg.author.id),
+	m_authorAvatar(msg.author.avatar),
+	m_authorFlags(msg.author.flags),
+	m_authorDiscriminator(msg.author.discriminator),
+	m_pinned(msg.pinned),
+	m_tts(msg.tts),
+	m_mentionEveryone(msg.mention_everyone)
+{
+	const std::string nickname = msg.member.get_nickname();
+	const std::string* fields[StringField_Count] = {
+		&msg.content,
+		&msg.author.username,
+		&msg.author.global_name,
+		&nickname,
+	};
+
+	size_t total = 0;
+	for (const std::string* field : fields) {
+		total += field->length() + 1;
+	}
+
+	m_strings.reserve(total);
+	for (int i = 0; i < StringField_Count; i++) {
+		m_offsets[i] = static_cast<uint32_t>(m_strings.length());
+		m_strings.append(*fields[i]);
+		m_strings.push_back('\0');
+	}
+}
+
+DiscordUser* DiscordWebhook::GetUser() const
+{
+	return new DiscordUser(std::shared_ptr<const dpp::user>(m_webhook, &m_webhook->user_obj));
+}
+
+DiscordUser* DiscordInteraction::GetUser() const
+{
+	return new DiscordUser(std::shared_ptr<const dpp::user>(m_interaction, &m_interaction->GetUser()));
+}
+
+DiscordUser* DiscordAutocompleteInteraction::GetUser() const
+{
+	return new DiscordUser(std::shared_ptr<const dpp::user>(m_interaction, &m_interaction->GetUser()));
+}
+
+std::shared_ptr<const dpp::user> MessageSnapshot::GetAuthor() const
+{
+	if (!m_author) {
+		auto author = std::make_shared<dpp::user>();
+		author->id = m_authorId;
+		author->username = GetString(StringField_AuthorName);
+		author->global_name = GetString(StringField_AuthorGlobalName);
+		author->avatar = m_authorAvatar;
+		author->flags = m_authorFlags;
+		author->discriminator = m_authorDiscriminator;
+		m_author = std::move(author);
+	}
+
+	return m_author;
+}
+
+DiscordUser* DiscordMessage::GetAuthor() const
+{
+	return new DiscordUser(m_snapshot->GetAuthor());
+}
+
+void DiscordClient::SetChoiceIndex(const std::string& command, const std::string& option, std::shared_ptr<const ChoiceIndex> index)
+{
+	std::shared_ptr<const ChoiceIndexMap> current = std::atomic_load(&m_choiceIndexes);
+	auto indexes = current ? std::make_shared<ChoiceIndexMap>(*current) : std::make_shared<ChoiceIndexMap>();
+
+	const std::string key = command + ':' + option;
+	if (index) {
+		(*indexes)[key] = std::move(index);
+	}
+	else {
+		indexes->erase(key);
+	}
+
+	std::atomic_store(&m_choiceIndexes, std::shared_ptr<const ChoiceIndexMap>(std::move(indexes)));
+}
+
+void DiscordClient::SetStaticResponse(const std::string& command, std::optional<StaticResponse> response)
+{
+	std::shared_ptr<const StaticResponseMap> current = std::atomic_load(&m_staticResponses);
+	auto responses = current ? std::make_shared<StaticResponseMap>(*current) : std::make_shared<StaticResponseMap>();
+
+	if (response) {
+		(*responses)[command] = std::move(*response);
+	}
+	else {
+		responses->erase(command);
+	}
+
+	std::atomic_store(&m_staticResponses, std::shared_ptr<const StaticResponseMap>(std::move(responses)));
+}
+
+bool DiscordClient::AnswerStaticResponse(const dpp::slashcommand_t& event)
+{
+	std::shared_ptr<const StaticResponseMap> responses = std::atomic_load(&m_staticResponses);
+	if (!responses || responses->empty()) {
+		return false;
+	}
+
+	auto it = responses->find(CommandRouter::GetCommandPath(event.command));
+	if (it == responses->end()) {
+		return false;
+	}
+
+	std::shared_ptr<const StatusValues> values = m_status.GetPublished();
+	event.reply(StatusStore::Render(it->second, values.get()));
+	return true;
+}
+
+bool DiscordClient::AnswerAutocomplete(const dpp::autocomplete_t& event, const OptionIndex& options)
+{
+	std::shared_ptr<const ChoiceIndexMap> indexes = std::atomic_load(&m_choiceIndexes);
+	if (!indexes || indexes->empty()) {
+		return false;
+	}
+
+	const IndexedOption* focused = options.GetFocused();
+	if (!focused) {
+		return false;
+	}
+
+	auto it = indexes->find(CommandRouter::GetCommandPath(event.command) + ':' + focused->name);
+	if (it == indexes->end()) {
+		return false;
+	}
+
+	std::string input;
+	OptionIndex::ToString(focused->value, input);
+
+	std::vector<const AutocompleteChoice*> matches;
+	it->second->Query(input, MAX_AUTOCOMPLETE_CHOICES, matches);
+
+	dpp::interaction_response response(dpp::ir_autocomplete_reply);
+	for (const AutocompleteChoice* choice : matches) {
+		response.add_autocomplete_choice(dpp::command_option_choice(choice->name, choice->value));
+	}
+
+	m_cluster->interaction_response_create(event.command.id, event.command.token, response);
+	return true;
+}
+
+void DiscordClient::OnDispatchEnd()
+{
+	FlushCoalesced(false);
+	FlushLiveMessages();
+	SyncCommands(false);
+
+	if (m_pendingBatch.empty()) {
+		return;
+	}
+
+	if (!g_pForwardMessageBatch || !g_pForwardMessageBatch->GetFunctionCount()) {
+		m_pendingBatch.clear();
+		return;
+	}
+
+	DiscordMessageBatch* batch = new DiscordMessageBatch(std::move(m_pendingBatch));
+	m_pendingBatch.clear();
+
+	HandleError err;
+	HandleSecurity sec;
+	sec.pOwner = myself->GetIdentity();
+	sec.pIdentity = myself->GetIdentity();
+
+	Handle_t batchHandle = handlesys->CreateHandleEx(g_DiscordMessageBatchHandle,
+		batch,
+		&sec,
+		nullptr,
+		&err);
+
+	if (batchHandle == BAD_HANDLE) {
+		delete batch;
+		return;
+	}
+
+	g_pForwardMessageBatch->PushCell(m_discord_handle);
+	g_pForwardMessageBatch->PushCell(batchHandle);
+	g_pForwardMessageBatch->Execute(nullptr);
+
+	handlesys->FreeHandle(batchHandle, &sec);
+}
+
 void DiscordClient::SetupEventHandlers()
 {
 	if (!m_cluster) {
@@ -331,9 +724,16 @@ void DiscordClient::SetupEventHandlers()
 		});
 
 	m_cluster->on_message_create([this](const dpp::message_create_t& event) {
-		g_TaskQueue.Push([this, msg = event.msg]() {
+		if ((!g_Subscriptions.IsSubscribed(EventKind_Message) && !g_Subscriptions.IsSubscribed(EventKind_MessageBatch))
+			|| !PassesMessageFilter(event.msg)) {
+			return;
+		}
+
+		g_TaskQueue.Push([this, msg = DiscordMessage(event.msg)]() mutable {
+			const bool batched = g_pForwardMessageBatch && g_pForwardMessageBatch->GetFunctionCount();
+
 			if (g_pForwardMessage && g_pForwardMessage->GetFunctionCount()) {
-				DiscordMessage* message = new DiscordMessage(msg);
+				DiscordMessage* message = batched ? new DiscordMessage(msg) : new DiscordMessage(std::move(msg));
 				HandleError err;
 				HandleSecurity sec;
 				sec.pOwner = myself->GetIdentity();
@@ -352,25 +752,48 @@ void DiscordClient::SetupEventHandlers()
 
 					handlesys->FreeHandle(messageHandle, &sec);
 				}
+				else {
+					delete message;
+				}
 			}
-			});
+
+			if (batched) {
+				m_pendingBatch.emplace_back(std::move(msg));
+			}
+			}, TaskLane_Message);
 		});
 
 	m_cluster->on_log([this](const dpp::log_t& event) {
-		if (event.severity >= dpp::ll_error) {
+		if (event.severity >= dpp::ll_error && g_Subscriptions.IsSubscribed(EventKind_Error)) {
 			g_TaskQueue.Push([this, message = event.message]() {
 			if (g_pForwardError && g_pForwardError->GetFunctionCount()) {
 				g_pForwardError->PushCell(m_discord_handle);
 				g_pForwardError->PushString(message.c_str());
 				g_pForwardError->Execute(nullptr);
 			}
-			});
+			}, TaskLane_Message);
 		}});
 
 	m_cluster->on_slashcommand([this](const dpp::slashcommand_t& event) {
-		g_TaskQueue.Push([this, event]() {
-			if (g_pForwardSlashCommand && g_pForwardSlashCommand->GetFunctionCount()) {
-				DiscordInteraction* interaction = new DiscordInteraction(event);
+		// Static responses are answered right here, without a trip through the game thread
+		if (AnswerStaticResponse(event)) {
+			return;
+		}
+
+		const bool routed = g_CommandRouter.HasRoutes();
+		if (!routed && !g_Subscriptions.IsSubscribed(EventKind_SlashCommand)) {
+			return;
+		}
+
+		auto state = std::make_shared<InteractionState>();
+		g_AutoDeferrer.Track(state, m_cluster.get(), event.command);
+
+		// Only what the natives need is kept, options are indexed here so they never walk the option tree
+		auto snapshot = std::make_shared<const InteractionSnapshot>(m_cluster, event.command, OptionIndex(event.command));
+
+		g_TaskQueue.Push([this, snapshot = std::move(snapshot), state]() {
+			if (g_CommandRouter.HasRoutes() || (g_pForwardSlashCommand && g_pForwardSlashCommand->GetFunctionCount())) {
+				DiscordInteraction* interaction = new DiscordInteraction(snapshot, state);
 
 				HandleError err;
 				HandleSecurity sec;
@@ -384,20 +807,40 @@ void DiscordClient::SetupEventHandlers()
 					&err);
 
 				if (interactionHandle != BAD_HANDLE) {
-					g_pForwardSlashCommand->PushCell(m_discord_handle);
-					g_pForwardSlashCommand->PushCell(interactionHandle);
-					g_pForwardSlashCommand->Execute(nullptr);
+					// A routed command only reaches its owner, everything else goes to the global forward
+					const bool dispatched = g_CommandRouter.HasRoutes() && g_CommandRouter.Dispatch(this, m_discord_handle, snapshot->GetCommandPath(), interactionHandle);
+					if (!dispatched && g_pForwardSlashCommand && g_pForwardSlashCommand->GetFunctionCount()) {
+						g_pForwardSlashCommand->PushCell(m_discord_handle);
+						g_pForwardSlashCommand->PushCell(interactionHandle);
+						g_pForwardSlashCommand->Execute(nullptr);
+					}
 
 					handlesys->FreeHandle(interactionHandle, &sec);
 				}
+				else {
+					delete interaction;
+				}
 			}
-			});
+			}, TaskLane_Interaction);
 		});
 
 	m_cluster->on_autocomplete([this](const dpp::autocomplete_t& event) {
-		g_TaskQueue.Push([this, event]() {
+		OptionIndex options(event.options);
+
+		// Options with a registered choice set never reach plugins
+		if (AnswerAutocomplete(event, options)) {
+			return;
+		}
+
+		if (!g_Subscriptions.IsSubscribed(EventKind_Autocomplete)) {
+			return;
+		}
+
+		auto snapshot = std::make_shared<const InteractionSnapshot>(m_cluster, event.command, std::move(options));
+
+		g_TaskQueue.Push([this, snapshot = std::move(snapshot)]() {
 			if (g_pForwardAutocomplete && g_pForwardAutocomplete->GetFunctionCount()) {
-				DiscordAutocompleteInteraction* interaction = new DiscordAutocompleteInteraction(event);
+				DiscordAutocompleteInteraction* interaction = new DiscordAutocompleteInteraction(snapshot);
 
 				HandleError err;
 				HandleSecurity sec;
@@ -411,22 +854,25 @@ void DiscordClient::SetupEventHandlers()
 						&err);
 
 				if (interactionHandle != BAD_HANDLE) {
-					std::string str;
-					for (auto & opt : event.options) {
-						dpp::command_option_type type = opt.type;
+					const OptionIndex& options = snapshot->GetOptions();
+					for (size_t i = 0; i < options.GetCount(); i++) {
+						const IndexedOption& opt = options.Get(i);
 
 						g_pForwardAutocomplete->PushCell(m_discord_handle);
 						g_pForwardAutocomplete->PushCell(interactionHandle);
-						g_pForwardAutocomplete->PushCell(opt.focused ? 1 : 0);
-						g_pForwardAutocomplete->PushCell(type);
+						g_pForwardAutocomplete->PushCell(&opt == options.GetFocused() ? 1 : 0);
+						g_pForwardAutocomplete->PushCell(opt.type);
 						g_pForwardAutocomplete->PushString(opt.name.c_str());
 						g_pForwardAutocomplete->Execute(nullptr);
 					}
-						}
 
-				handlesys->FreeHandle(interactionHandle, &sec);
+					handlesys->FreeHandle(interactionHandle, &sec);
+				}
+				else {
+					delete interaction;
+				}
 			}
-		});
+		}, TaskLane_Interaction);
 	});
 }
 
@@ -661,6 +1107,35 @@ static cell_t discord_CreateWebhook(IPluginContext* pContext, const cell_t* para
 	}
 }
 
+// The completion callback and its data trail the optional parameters, plugins compiled before they existed pass fewer
+static IChangeableForward* CreateSendForward(IPluginContext* pContext, const cell_t* params, int callbackParam)
+{
+	if (params[0] < callbackParam) {
+		return nullptr;
+	}
+
+	IPluginFunction* callback = pContext->GetFunctionById(params[callbackParam]);
+	if (!callback) {
+		return nullptr;
+	}
+
+	IChangeableForward* forward = forwards->CreateForwardEx(nullptr, ET_Ignore, 7, nullptr, Param_Cell, Param_Cell, Param_String, Param_String, Param_Cell, Param_Cell, Param_Any);
+	if (!forward || !forward->AddFunction(callback)) {
+		if (forward) {
+			forwards->ReleaseForward(forward);
+		}
+		pContext->ReportError("Could not create forward.");
+		return nullptr;
+	}
+
+	return forward;
+}
+
+static cell_t GetSendCallbackData(const cell_t* params, int callbackParam)
+{
+	return params[0] > callbackParam ? params[callbackParam + 1] : 0;
+}
+
 static cell_t discord_ExecuteWebhook(IPluginContext* pContext, const cell_t* params)
 {
 	DiscordClient* discord = GetDiscordPointer(pContext, params[1]);
@@ -707,7 +1182,7 @@ static cell_t discord_ExecuteWebhook(IPluginContext* pContext, const cell_t* par
 	}
 
 	try {
-		return discord->ExecuteWebhook(webhook->m_webhook, message, params[4], users, roles) ? 1 : 0;
+		return discord->ExecuteWebhook(*webhook->m_webhook, message, params[4], users, roles, CreateSendForward(pContext, params, 9), GetSendCallbackData(params, 9)) ? 1 : 0;
 	}
 	catch (const std::exception& e) {
 		pContext->ReportError("Failed to execute webhook: %s", e.what());
@@ -763,7 +1238,7 @@ static cell_t discord_SendMessage(IPluginContext* pContext, const cell_t* params
 
 	try {
 		dpp::snowflake channel = std::stoull(channelId);
-		return discord->SendMessage(channel, message, params[4], users, roles) ? 1 : 0;
+		return discord->SendMessage(channel, message, params[4], users, roles, CreateSendForward(pContext, params, 9), GetSendCallbackData(params, 9)) ? 1 : 0;
 	}
 	catch (const std::exception& e) {
 		pContext->ReportError("Invalid channel ID format: %s", channelId);
@@ -828,7 +1303,7 @@ static cell_t discord_SendMessageEmbed(IPluginContext* pContext, const cell_t* p
 
 	try {
 		dpp::snowflake channel = std::stoull(channelId);
-		return discord->SendMessageEmbed(channel, message, embed, params[5], users, roles) ? 1 : 0;
+		return discord->SendMessageEmbed(channel, message, embed, params[5], users, roles, CreateSendForward(pContext, params, 10), GetSendCallbackData(params, 10)) ? 1 : 0;
 	}
 	catch (const std::exception& e) {
 		pContext->ReportError("Invalid channel ID format: %s", channelId);
@@ -1225,6 +1700,30 @@ static cell_t message_GetAuthor(IPluginContext* pContext, const cell_t* params)
 	return handle;
 }
 
+static cell_t message_Retain(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordMessage* message = GetMessagePointer(pContext, params[1]);
+	if (!message) {
+		return BAD_HANDLE;
+	}
+
+	// Shares the snapshot, only its refcount is bumped
+	DiscordMessage* copy = new DiscordMessage(*message);
+
+	HandleError err;
+	HandleSecurity sec(pContext->GetIdentity(), myself->GetIdentity());
+	Handle_t handle = handlesys->CreateHandleEx(g_DiscordMessageHandle, copy, &sec, nullptr, &err);
+
+	if (handle == BAD_HANDLE)
+	{
+		delete copy;
+		pContext->ReportError("Could not create message handle (error %d)", err);
+		return BAD_HANDLE;
+	}
+
+	return handle;
+}
+
 static cell_t message_GetAuthorId(IPluginContext* pContext, const cell_t* params)
 {
 	DiscordMessage* message = GetMessagePointer(pContext, params[1]);
@@ -1289,40 +1788,191 @@ static cell_t message_IsBot(IPluginContext* pContext, const cell_t* params)
 	return message->IsBot() ? 1 : 0;
 }
 
-static DiscordChannel* GetChannelPointer(IPluginContext* pContext, Handle_t handle)
+static DiscordMessageBatch* GetMessageBatchPointer(IPluginContext* pContext, Handle_t handle)
 {
 	HandleError err;
 	HandleSecurity sec(pContext->GetIdentity(), myself->GetIdentity());
 
-	DiscordChannel* channel;
-	if ((err = handlesys->ReadHandle(handle, g_DiscordChannelHandle, &sec, (void**)&channel)) != HandleError_None)
+	DiscordMessageBatch* batch;
+	if ((err = handlesys->ReadHandle(handle, g_DiscordMessageBatchHandle, &sec, (void**)&batch)) != HandleError_None)
 	{
-		pContext->ThrowNativeError("Invalid Discord channel handle %x (error %d)", handle, err);
+		pContext->ThrowNativeError("Invalid Discord message batch handle %x (error %d)", handle, err);
 		return nullptr;
 	}
 
-	return channel;
+	return batch;
 }
 
-// Channel natives
-static cell_t channel_GetName(IPluginContext* pContext, const cell_t* params)
+static const DiscordMessage* GetBatchMessage(IPluginContext* pContext, const cell_t* params)
 {
-	DiscordChannel* channel = GetChannelPointer(pContext, params[1]);
-	if (!channel) {
-		return 0;
+	DiscordMessageBatch* batch = GetMessageBatchPointer(pContext, params[1]);
+	if (!batch) {
+		return nullptr;
 	}
 
-	pContext->StringToLocal(params[2], params[3], channel->GetName());
-	return 1;
+	if (!batch->IsValidIndex(params[2])) {
+		pContext->ThrowNativeError("Invalid message index %d (count %d)", params[2], static_cast<int>(batch->GetCount()));
+		return nullptr;
+	}
+
+	return &batch->GetMessage(params[2]);
 }
 
-// Webhook natives
-static cell_t webhook_CreateWebhook(IPluginContext* pContext, const cell_t* params)
+// Message batch natives
+static cell_t batch_GetCount(IPluginContext* pContext, const cell_t* params)
 {
-	char* webhook_url;
-	pContext->LocalToString(params[1], &webhook_url);
+	DiscordMessageBatch* batch = GetMessageBatchPointer(pContext, params[1]);
+	if (!batch) {
+		return 0;
+	}
 
-	dpp::webhook webhook;
+	return static_cast<cell_t>(batch->GetCount());
+}
+
+static cell_t batch_GetMessage(IPluginContext* pContext, const cell_t* params)
+{
+	const DiscordMessage* message = GetBatchMessage(pContext, params);
+	if (!message) {
+		return BAD_HANDLE;
+	}
+
+	DiscordMessage* copy = new DiscordMessage(*message);
+
+	HandleError err;
+	HandleSecurity sec(pContext->GetIdentity(), myself->GetIdentity());
+	Handle_t handle = handlesys->CreateHandleEx(g_DiscordMessageHandle, copy, &sec, nullptr, &err);
+
+	if (handle == BAD_HANDLE)
+	{
+		delete copy;
+		pContext->ReportError("Could not create message handle (error %d)", err);
+		return BAD_HANDLE;
+	}
+
+	return handle;
+}
+
+static cell_t batch_GetContent(IPluginContext* pContext, const cell_t* params)
+{
+	const DiscordMessage* message = GetBatchMessage(pContext, params);
+	if (!message) {
+		return 0;
+	}
+
+	pContext->StringToLocal(params[3], params[4], message->GetContent());
+	return 1;
+}
+
+static cell_t batch_GetMessageId(IPluginContext* pContext, const cell_t* params)
+{
+	const DiscordMessage* message = GetBatchMessage(pContext, params);
+	if (!message) {
+		return 0;
+	}
+
+	pContext->StringToLocal(params[3], params[4], message->GetMessageId().c_str());
+	return 1;
+}
+
+static cell_t batch_GetChannelId(IPluginContext* pContext, const cell_t* params)
+{
+	const DiscordMessage* message = GetBatchMessage(pContext, params);
+	if (!message) {
+		return 0;
+	}
+
+	pContext->StringToLocal(params[3], params[4], message->GetChannelId().c_str());
+	return 1;
+}
+
+static cell_t batch_GetGuildId(IPluginContext* pContext, const cell_t* params)
+{
+	const DiscordMessage* message = GetBatchMessage(pContext, params);
+	if (!message) {
+		return 0;
+	}
+
+	pContext->StringToLocal(params[3], params[4], message->GetGuildId().c_str());
+	return 1;
+}
+
+static cell_t batch_GetAuthorId(IPluginContext* pContext, const cell_t* params)
+{
+	const DiscordMessage* message = GetBatchMessage(pContext, params);
+	if (!message) {
+		return 0;
+	}
+
+	pContext->StringToLocal(params[3], params[4], message->GetAuthorId().c_str());
+	return 1;
+}
+
+static cell_t batch_GetAuthorName(IPluginContext* pContext, const cell_t* params)
+{
+	const DiscordMessage* message = GetBatchMessage(pContext, params);
+	if (!message) {
+		return 0;
+	}
+
+	pContext->StringToLocal(params[3], params[4], message->GetAuthorName());
+	return 1;
+}
+
+static cell_t batch_GetAuthorDisplayName(IPluginContext* pContext, const cell_t* params)
+{
+	const DiscordMessage* message = GetBatchMessage(pContext, params);
+	if (!message) {
+		return 0;
+	}
+
+	pContext->StringToLocal(params[3], params[4], message->GetAuthorDisplayName());
+	return 1;
+}
+
+static cell_t batch_IsBot(IPluginContext* pContext, const cell_t* params)
+{
+	const DiscordMessage* message = GetBatchMessage(pContext, params);
+	if (!message) {
+		return 0;
+	}
+
+	return message->IsBot() ? 1 : 0;
+}
+
+static DiscordChannel* GetChannelPointer(IPluginContext* pContext, Handle_t handle)
+{
+	HandleError err;
+	HandleSecurity sec(pContext->GetIdentity(), myself->GetIdentity());
+
+	DiscordChannel* channel;
+	if ((err = handlesys->ReadHandle(handle, g_DiscordChannelHandle, &sec, (void**)&channel)) != HandleError_None)
+	{
+		pContext->ThrowNativeError("Invalid Discord channel handle %x (error %d)", handle, err);
+		return nullptr;
+	}
+
+	return channel;
+}
+
+// Channel natives
+static cell_t channel_GetName(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordChannel* channel = GetChannelPointer(pContext, params[1]);
+	if (!channel) {
+		return 0;
+	}
+
+	pContext->StringToLocal(params[2], params[3], channel->GetName());
+	return 1;
+}
+
+// Webhook natives
+static cell_t webhook_CreateWebhook(IPluginContext* pContext, const cell_t* params)
+{
+	char* webhook_url;
+	pContext->LocalToString(params[1], &webhook_url);
+
+	dpp::webhook webhook;
 	try
 	{
 			webhook = dpp::webhook(webhook_url);
@@ -1471,7 +2121,7 @@ bool DiscordClient::RegisterSlashCommand(dpp::snowflake guild_id, const char* na
 			command.set_default_permissions(std::stoull(default_permissions));
 		}
 
-		m_cluster->guild_command_create(command, guild_id);
+		CreateCommand(command, guild_id);
 		return true;
 	}
 	catch (const std::exception& e) {
@@ -1496,7 +2146,7 @@ bool DiscordClient::RegisterGlobalSlashCommand(const char* name, const char* des
 			command.set_default_permissions(std::stoull(default_permissions));
 		}
 
-		m_cluster->global_command_create(command);
+		CreateCommand(command, 0);
 		return true;
 	}
 	catch (const std::exception& e) {
@@ -1505,6 +2155,182 @@ bool DiscordClient::RegisterGlobalSlashCommand(const char* name, const char* des
 	}
 }
 
+void DiscordClient::CreateCommand(const dpp::slashcommand& command, dpp::snowflake guild_id)
+{
+	if (m_manifest.IsEnabled()) {
+		m_manifest.Add(guild_id, command);
+	}
+	else if (guild_id) {
+		m_cluster->guild_command_create(command, guild_id);
+	}
+	else {
+		m_cluster->global_command_create(command);
+	}
+}
+
+void DiscordClient::EnableCommandManifest(int settleMs)
+{
+	m_manifest.Enable(settleMs);
+}
+
+bool DiscordClient::SyncCommands(bool force)
+{
+	if (!m_manifest.IsEnabled()) {
+		return false;
+	}
+
+	if (!m_isRunning) {
+		return false;
+	}
+
+	LoadCommandCache();
+	for (dpp::snowflake guild_id : m_manifest.TakeDue(force)) {
+		SyncCommandScope(guild_id);
+	}
+	return true;
+}
+
+void DiscordClient::SyncCommandScope(dpp::snowflake guild_id)
+{
+	const uint64_t hash = m_manifest.GetHash(guild_id);
+	std::vector<dpp::slashcommand> commands = m_manifest.GetCommands(guild_id);
+
+	// Same set as the last sync, most map changes end here without a request
+	if (hash == m_manifest.GetSyncedHash(guild_id)) {
+		CommandSyncResult result;
+		result.unchanged = static_cast<int>(commands.size());
+		FinishCommandSync(guild_id, true, hash, result, std::nullopt);
+		return;
+	}
+
+	auto onFetched = [this, guild_id, hash, commands = std::move(commands)](const dpp::confirmation_callback_t& fetched) {
+		if (fetched.is_error()) {
+			smutils->LogError(myself, "Failed to fetch commands for sync: %s", fetched.get_error().message.c_str());
+			g_TaskQueue.Push([this, guild_id, hash]() {
+				FinishCommandSync(guild_id, false, hash, CommandSyncResult(), std::nullopt);
+			});
+			return;
+		}
+
+		const dpp::slashcommand_map& current = std::get<dpp::slashcommand_map>(fetched.value);
+		CommandSyncResult result = CommandManifest::Diff(commands, current);
+		if (result.IsUnchanged()) {
+			g_TaskQueue.Push([this, guild_id, hash, result, ids = CommandManifest::GetIds(current)]() mutable {
+				FinishCommandSync(guild_id, true, hash, result, std::move(ids));
+			});
+			return;
+		}
+
+		auto onOverwritten = [this, guild_id, hash, result](const dpp::confirmation_callback_t& written) {
+			const bool success = !written.is_error();
+			std::optional<CommandManifest::CommandIdMap> ids;
+			if (success) {
+				ids = CommandManifest::GetIds(std::get<dpp::slashcommand_map>(written.value));
+			}
+			else {
+				smutils->LogError(myself, "Failed to overwrite commands: %s", written.get_error().message.c_str());
+			}
+
+			g_TaskQueue.Push([this, guild_id, hash, success, result, ids = std::move(ids)]() mutable {
+				FinishCommandSync(guild_id, success, hash, success ? result : CommandSyncResult(), std::move(ids));
+			});
+		};
+
+		if (guild_id) {
+			m_cluster->guild_bulk_command_create(commands, guild_id, onOverwritten);
+		}
+		else {
+			m_cluster->global_bulk_command_create(commands, onOverwritten);
+		}
+	};
+
+	try {
+		if (guild_id) {
+			m_cluster->guild_commands_get(guild_id, onFetched);
+		}
+		else {
+			m_cluster->global_commands_get(onFetched);
+		}
+	}
+	catch (const std::exception& e) {
+		smutils->LogError(myself, "Failed to sync commands: %s", e.what());
+		FinishCommandSync(guild_id, false, hash, CommandSyncResult(), std::nullopt);
+	}
+}
+
+void DiscordClient::FinishCommandSync(dpp::snowflake guild_id, bool success, uint64_t hash, const CommandSyncResult& result, std::optional<CommandManifest::CommandIdMap> ids)
+{
+	const bool sent = success && ids;
+	m_manifest.OnSynced(guild_id, success, hash, std::move(ids));
+	if (sent) {
+		SaveCommandCache();
+	}
+
+	if (g_pForwardCommandsSynced && g_pForwardCommandsSynced->GetFunctionCount()) {
+		g_pForwardCommandsSynced->PushCell(m_discord_handle);
+		g_pForwardCommandsSynced->PushString(guild_id ? std::to_string(guild_id).c_str() : "");
+		g_pForwardCommandsSynced->PushCell(success ? 1 : 0);
+		g_pForwardCommandsSynced->PushCell(result.created);
+		g_pForwardCommandsSynced->PushCell(result.changed);
+		g_pForwardCommandsSynced->PushCell(result.unchanged);
+		g_pForwardCommandsSynced->PushCell(result.removed);
+		g_pForwardCommandsSynced->Execute(nullptr);
+	}
+}
+
+// One file per application, so bots sharing a server do not overwrite each other's cache
+bool DiscordClient::BuildCommandCachePath(char* buffer, size_t maxlength)
+{
+	if (!m_cluster || !m_cluster->me.id) {
+		return false;
+	}
+
+	smutils->BuildPath(Path_SM, buffer, maxlength, "data/discord/commands_%s.json", std::to_string(m_cluster->me.id).c_str());
+	return true;
+}
+
+void DiscordClient::LoadCommandCache()
+{
+	char path[PLATFORM_MAX_PATH];
+	if (m_commandCacheLoaded || !BuildCommandCachePath(path, sizeof(path))) {
+		return;
+	}
+	m_commandCacheLoaded = true;
+
+	if (libsys->PathExists(path) && !m_manifest.Load(path, m_cluster->me.id)) {
+		smutils->LogError(myself, "Ignoring invalid command cache %s", path);
+	}
+}
+
+void DiscordClient::SaveCommandCache()
+{
+	char path[PLATFORM_MAX_PATH];
+	if (!BuildCommandCachePath(path, sizeof(path))) {
+		return;
+	}
+
+	char dir[PLATFORM_MAX_PATH];
+	smutils->BuildPath(Path_SM, dir, sizeof(dir), "data/discord");
+	if (!libsys->IsPathDirectory(dir) && !libsys->CreateFolder(dir)) {
+		smutils->LogError(myself, "Failed to create %s", dir);
+		return;
+	}
+
+	if (!m_manifest.Save(path, m_cluster->me.id)) {
+		smutils->LogError(myself, "Failed to write command cache %s", path);
+	}
+}
+
+dpp::snowflake DiscordClient::ResolveCommandId(dpp::snowflake guild_id, const char* command)
+{
+	if (*command && strspn(command, "0123456789") == strlen(command)) {
+		return std::stoull(command);
+	}
+
+	LoadCommandCache();
+	return m_manifest.FindId(guild_id, command);
+}
+
 static cell_t discord_RegisterSlashCommand(IPluginContext* pContext, const cell_t* params)
 {
 	DiscordClient* discord = GetDiscordPointer(pContext, params[1]);
@@ -1579,7 +2405,10 @@ static cell_t interaction_CreateResponse(IPluginContext* pContext, const cell_t*
 	char* content;
 	pContext->LocalToString(params[2], &content);
 
-	interaction->CreateResponse(content);
+	if (!interaction->CreateResponse(content)) {
+		pContext->ReportError("Discord client of this interaction is no longer running");
+		return 0;
+	}
 	return 1;
 }
 
@@ -1601,7 +2430,10 @@ static cell_t interaction_CreateResponseEmbed(IPluginContext* pContext, const ce
 		return pContext->ThrowNativeError("Invalid Discord embed handle %x (error %d)", params[3], err);
 	}
 
-	interaction->CreateResponseEmbed(content, embed);
+	if (!interaction->CreateResponseEmbed(content, embed)) {
+		pContext->ReportError("Discord client of this interaction is no longer running");
+		return 0;
+	}
 	return 1;
 }
 
@@ -1679,92 +2511,192 @@ static cell_t interaction_GetOptionValueBool(IPluginContext* pContext, const cel
 	return value ? 1 : 0;
 }
 
-static cell_t interaction_DeferReply(IPluginContext* pContext, const cell_t* params)
+static const IndexedOption* GetInteractionOption(IPluginContext* pContext, const cell_t* params)
 {
 	DiscordInteraction* interaction = GetInteractionPointer(pContext, params[1]);
 	if (!interaction) {
-		return 0;
+		return nullptr;
 	}
 
-	interaction->DeferReply(params[2] ? true : false);
-	return 1;
+	const OptionIndex& options = interaction->GetOptions();
+	if (params[2] < 0 || static_cast<size_t>(params[2]) >= options.GetCount()) {
+		pContext->ReportError("Invalid option index %d (count: %d)", params[2], static_cast<int>(options.GetCount()));
+		return nullptr;
+	}
+
+	return &options.Get(params[2]);
 }
 
-static cell_t interaction_EditResponse(IPluginContext* pContext, const cell_t* params)
+static cell_t interaction_GetOptionCount(IPluginContext* pContext, const cell_t* params)
 {
 	DiscordInteraction* interaction = GetInteractionPointer(pContext, params[1]);
 	if (!interaction) {
 		return 0;
 	}
 
-	char* content;
-	pContext->LocalToString(params[2], &content);
-
-	interaction->EditResponse(content);
-	return 1;
+	return static_cast<cell_t>(interaction->GetOptions().GetCount());
 }
 
-static cell_t interaction_CreateEphemeralResponse(IPluginContext* pContext, const cell_t* params)
+static cell_t interaction_FindOption(IPluginContext* pContext, const cell_t* params)
 {
 	DiscordInteraction* interaction = GetInteractionPointer(pContext, params[1]);
 	if (!interaction) {
-		return 0;
+		return -1;
 	}
 
-	char* content;
-	pContext->LocalToString(params[2], &content);
+	char* name;
+	pContext->LocalToString(params[2], &name);
 
-	interaction->CreateEphemeralResponse(content);
-	return 1;
+	return interaction->GetOptions().Find(name);
 }
 
-static cell_t interaction_CreateEphemeralResponseEmbed(IPluginContext* pContext, const cell_t* params)
+static cell_t interaction_GetOptionName(IPluginContext* pContext, const cell_t* params)
 {
-	DiscordInteraction* interaction = GetInteractionPointer(pContext, params[1]);
-	if (!interaction) {
+	const IndexedOption* option = GetInteractionOption(pContext, params);
+	if (!option) {
 		return 0;
 	}
 
-	char* content;
-	pContext->LocalToString(params[2], &content);
-
-	HandleError err;
-	HandleSecurity sec(pContext->GetIdentity(), myself->GetIdentity());
-	DiscordEmbed* embed;
-	if ((err = handlesys->ReadHandle(params[3], g_DiscordEmbedHandle, &sec, (void**)&embed)) != HandleError_None)
-	{
-		return pContext->ThrowNativeError("Invalid Discord embed handle %x (error %d)", params[3], err);
-	}
-
-	interaction->CreateEphemeralResponseEmbed(content, embed);
+	pContext->StringToLocal(params[3], params[4], option->name.c_str());
 	return 1;
 }
 
-static cell_t interaction_GetCommandName(IPluginContext* pContext, const cell_t* params)
+static cell_t interaction_GetOptionType(IPluginContext* pContext, const cell_t* params)
 {
-	DiscordInteraction* interaction = GetInteractionPointer(pContext, params[1]);
-	if (!interaction) {
+	const IndexedOption* option = GetInteractionOption(pContext, params);
+	if (!option) {
 		return 0;
 	}
 
-	const char* commandName = interaction->GetCommandName();
-	pContext->StringToLocal(params[2], params[3], commandName);
-	return 1;
+	return static_cast<cell_t>(option->type);
 }
 
-static cell_t interaction_GetGuildId(IPluginContext* pContext, const cell_t* params)
+static cell_t interaction_GetOptionValueAt(IPluginContext* pContext, const cell_t* params)
 {
-	DiscordInteraction* interaction = GetInteractionPointer(pContext, params[1]);
-	if (!interaction) {
+	const IndexedOption* option = GetInteractionOption(pContext, params);
+	if (!option) {
 		return 0;
 	}
 
-	std::string guildId = interaction->GetGuildId();
-	pContext->StringToLocal(params[2], params[3], guildId.c_str());
+	std::string value;
+	if (!OptionIndex::ToString(option->value, value)) {
+		return 0;
+	}
+
+	pContext->StringToLocal(params[3], params[4], value.c_str());
 	return 1;
 }
 
-static cell_t interaction_GetChannelId(IPluginContext* pContext, const cell_t* params)
+static cell_t interaction_GetSubcommandPath(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordInteraction* interaction = GetInteractionPointer(pContext, params[1]);
+	if (!interaction) {
+		return 0;
+	}
+
+	const char* path = interaction->GetOptions().GetSubcommandPath();
+	pContext->StringToLocal(params[2], params[3], path);
+	return path[0] != '\0';
+}
+
+static cell_t interaction_DeferReply(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordInteraction* interaction = GetInteractionPointer(pContext, params[1]);
+	if (!interaction) {
+		return 0;
+	}
+
+	if (!interaction->DeferReply(params[2] ? true : false)) {
+		pContext->ReportError("Discord client of this interaction is no longer running");
+		return 0;
+	}
+	return 1;
+}
+
+static cell_t interaction_EditResponse(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordInteraction* interaction = GetInteractionPointer(pContext, params[1]);
+	if (!interaction) {
+		return 0;
+	}
+
+	char* content;
+	pContext->LocalToString(params[2], &content);
+
+	if (!interaction->EditResponse(content)) {
+		pContext->ReportError("Discord client of this interaction is no longer running");
+		return 0;
+	}
+	return 1;
+}
+
+static cell_t interaction_CreateEphemeralResponse(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordInteraction* interaction = GetInteractionPointer(pContext, params[1]);
+	if (!interaction) {
+		return 0;
+	}
+
+	char* content;
+	pContext->LocalToString(params[2], &content);
+
+	if (!interaction->CreateEphemeralResponse(content)) {
+		pContext->ReportError("Discord client of this interaction is no longer running");
+		return 0;
+	}
+	return 1;
+}
+
+static cell_t interaction_CreateEphemeralResponseEmbed(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordInteraction* interaction = GetInteractionPointer(pContext, params[1]);
+	if (!interaction) {
+		return 0;
+	}
+
+	char* content;
+	pContext->LocalToString(params[2], &content);
+
+	HandleError err;
+	HandleSecurity sec(pContext->GetIdentity(), myself->GetIdentity());
+	DiscordEmbed* embed;
+	if ((err = handlesys->ReadHandle(params[3], g_DiscordEmbedHandle, &sec, (void**)&embed)) != HandleError_None)
+	{
+		return pContext->ThrowNativeError("Invalid Discord embed handle %x (error %d)", params[3], err);
+	}
+
+	if (!interaction->CreateEphemeralResponseEmbed(content, embed)) {
+		pContext->ReportError("Discord client of this interaction is no longer running");
+		return 0;
+	}
+	return 1;
+}
+
+static cell_t interaction_GetCommandName(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordInteraction* interaction = GetInteractionPointer(pContext, params[1]);
+	if (!interaction) {
+		return 0;
+	}
+
+	const char* commandName = interaction->GetCommandName();
+	pContext->StringToLocal(params[2], params[3], commandName);
+	return 1;
+}
+
+static cell_t interaction_GetGuildId(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordInteraction* interaction = GetInteractionPointer(pContext, params[1]);
+	if (!interaction) {
+		return 0;
+	}
+
+	std::string guildId = interaction->GetGuildId();
+	pContext->StringToLocal(params[2], params[3], guildId.c_str());
+	return 1;
+}
+
+static cell_t interaction_GetChannelId(IPluginContext* pContext, const cell_t* params)
 {
 	DiscordInteraction* interaction = GetInteractionPointer(pContext, params[1]);
 	if (!interaction) {
@@ -1799,6 +2731,30 @@ static cell_t interaction_GetUser(IPluginContext* pContext, const cell_t* params
 	return handle;
 }
 
+static cell_t interaction_Retain(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordInteraction* interaction = GetInteractionPointer(pContext, params[1]);
+	if (!interaction) {
+		return BAD_HANDLE;
+	}
+
+	// Shares the event and reply state, so auto-defer and responses keep working
+	DiscordInteraction* copy = new DiscordInteraction(*interaction);
+
+	HandleError err;
+	HandleSecurity sec(pContext->GetIdentity(), myself->GetIdentity());
+	Handle_t handle = handlesys->CreateHandleEx(g_DiscordInteractionHandle, copy, &sec, nullptr, &err);
+
+	if (handle == BAD_HANDLE)
+	{
+		delete copy;
+		pContext->ReportError("Could not create interaction handle (error %d)", err);
+		return BAD_HANDLE;
+	}
+
+	return handle;
+}
+
 static cell_t interaction_GetUserId(IPluginContext* pContext, const cell_t* params)
 {
 	DiscordInteraction* interaction = GetInteractionPointer(pContext, params[1]);
@@ -1930,7 +2886,11 @@ static cell_t autocomplete_GetOptionValue(IPluginContext* pContext, const cell_t
 	char* name;
 	pContext->LocalToString(params[2], &name);
 
-	std::string value = interaction->GetOptionValue(name);
+	std::string value;
+	if (!interaction->GetOptionValue(name, value)) {
+		return 0;
+	}
+
 	pContext->StringToLocal(params[3], params[4], value.c_str());
 	return 1;
 }
@@ -1945,7 +2905,11 @@ static cell_t autocomplete_GetOptionValueInt(IPluginContext* pContext, const cel
 	char* name;
 	pContext->LocalToString(params[2], &name);
 
-	int64_t value = interaction->GetOptionValueInt(name);
+	int64_t value;
+	if (!interaction->GetOptionValueInt(name, value)) {
+		return 0;
+	}
+
 	return value;
 }
 
@@ -1959,7 +2923,11 @@ static cell_t autocomplete_GetOptionValueFloat(IPluginContext* pContext, const c
 	char* name;
 	pContext->LocalToString(params[2], &name);
 
-	double value = interaction->GetOptionValueDouble(name);
+	double value;
+	if (!interaction->GetOptionValueDouble(name, value)) {
+		return 0;
+	}
+
 	return sp_ftoc((float)value);
 }
 
@@ -1973,8 +2941,45 @@ static cell_t autocomplete_GetOptionValueBool(IPluginContext* pContext, const ce
 	char* name;
 	pContext->LocalToString(params[2], &name);
 
-	bool value = interaction->GetOptionValueBool(name);
-	return value;
+	bool value;
+	if (!interaction->GetOptionValueBool(name, value)) {
+		return 0;
+	}
+
+	return value ? 1 : 0;
+}
+
+static cell_t autocomplete_GetFocusedOptionName(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordAutocompleteInteraction* interaction = GetAutocompleteInteractionPointer(pContext, params[1]);
+	if (!interaction) {
+		return 0;
+	}
+
+	const IndexedOption* focused = interaction->GetOptions().GetFocused();
+	if (!focused) {
+		return 0;
+	}
+
+	pContext->StringToLocal(params[2], params[3], focused->name.c_str());
+	return 1;
+}
+
+static cell_t autocomplete_GetFocusedOptionValue(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordAutocompleteInteraction* interaction = GetAutocompleteInteractionPointer(pContext, params[1]);
+	if (!interaction) {
+		return 0;
+	}
+
+	const IndexedOption* focused = interaction->GetOptions().GetFocused();
+	std::string value;
+	if (!focused || !OptionIndex::ToString(focused->value, value)) {
+		return 0;
+	}
+
+	pContext->StringToLocal(params[2], params[3], value.c_str());
+	return 1;
 }
 
 static cell_t autocomplete_AddAutocompleteChoice(IPluginContext* pContext, const cell_t* params)
@@ -2005,7 +3010,7 @@ static cell_t autocomplete_AddAutocompleteChoice(IPluginContext* pContext, const
 			break;
 	}
 
-	interaction->m_response.add_autocomplete_choice(dpp::command_option_choice(name, value));
+	interaction->AddAutocompleteOption(dpp::command_option_choice(name, value));
 	return 1;
 }
 
@@ -2022,7 +3027,7 @@ static cell_t autocomplete_AddAutocompleteChoiceString(IPluginContext* pContext,
 	char* str_value;
 	pContext->LocalToString(params[4], &str_value);
 
-	interaction->m_response.add_autocomplete_choice(dpp::command_option_choice(name, std::string(str_value)));
+	interaction->AddAutocompleteOption(dpp::command_option_choice(name, std::string(str_value)));
 	return 1;
 }
 
@@ -2038,12 +3043,16 @@ static cell_t autocomplete_CreateAutocompleteResponse(IPluginContext* pContext,
 		return 0;
 	}
 
-	discord->CreateAutocompleteResponse(interaction->m_command.id, interaction->m_command.token, interaction->m_response);
+	discord->CreateAutocompleteResponse(interaction->GetCommand().GetId(), interaction->GetCommand().GetToken(), interaction->BuildResponse());
 	return 1;
 }
 
 void DiscordClient::CreateAutocompleteResponse(dpp::snowflake id, const std::string &token, const dpp::interaction_response &response)
 {
+	if (!m_isRunning) {
+		return;
+	}
+
 	m_cluster->interaction_response_create(id, token, response);
 }
 
@@ -2088,6 +3097,56 @@ bool DiscordClient::EditMessageEmbed(dpp::snowflake channel_id, dpp::snowflake m
 	}
 }
 
+std::shared_ptr<LiveMessage> DiscordClient::GetLiveMessage(dpp::snowflake channel_id, dpp::snowflake message_id, int intervalMs)
+{
+	std::shared_ptr<LiveMessage>& live = m_liveMessages[message_id];
+	if (!live) {
+		live = std::make_shared<LiveMessage>(channel_id, message_id, intervalMs);
+	}
+	else {
+		live->SetInterval(intervalMs);
+	}
+
+	return live;
+}
+
+void DiscordClient::FlushLiveMessages()
+{
+	if (!m_isRunning) {
+		return;
+	}
+
+	for (auto it = m_liveMessages.begin(); it != m_liveMessages.end();) {
+		std::shared_ptr<LiveMessage>& live = it->second;
+		if (live->IsDue()) {
+			try {
+				m_cluster->message_edit(live->TakeEdit(), [live](const dpp::confirmation_callback_t& callback) {
+					const bool success = !callback.is_error();
+					// Other client errors, such as a deleted message, would only fail again
+					const uint16_t status = callback.http_info.status;
+					const bool retry = !success && (status == 0 || status == 429 || status >= 500);
+					if (!success) {
+						smutils->LogError(myself, "Failed to edit live message: %s", callback.get_error().message.c_str());
+					}
+
+					g_TaskQueue.Push([live, success, retry]() {
+						live->OnEditDone(success, retry);
+					}, TaskLane_Message);
+				});
+			}
+			catch (const std::exception& e) {
+				live->OnEditDone(false, false);
+				smutils->LogError(myself, "Failed to edit live message: %s", e.what());
+			}
+		}
+		else if (live.use_count() == 1 && live->IsIdle()) {
+			it = m_liveMessages.erase(it);
+			continue;
+		}
+		++it;
+	}
+}
+
 bool DiscordClient::DeleteMessage(dpp::snowflake channel_id, dpp::snowflake message_id)
 {
 	if (!m_isRunning) {
@@ -2209,7 +3268,7 @@ bool DiscordClient::RegisterSlashCommandWithOptions(dpp::snowflake guild_id, con
 		}
 
 		command.options = options;
-		m_cluster->guild_command_create(command, guild_id);
+		CreateCommand(command, guild_id);
 		return true;
 	}
 	catch (const std::exception& e) {
@@ -2236,7 +3295,7 @@ bool DiscordClient::RegisterGlobalSlashCommandWithOptions(const char* name, cons
 		}
 
 		command.options = options;
-		m_cluster->global_command_create(command);
+		CreateCommand(command, 0);
 		return true;
 	}
 	catch (const std::exception& e) {
@@ -2368,6 +3427,10 @@ bool DiscordClient::DeleteGuildCommand(dpp::snowflake guild_id, dpp::snowflake c
 	}
 
 	try {
+		LoadCommandCache();
+		if (m_manifest.Remove(guild_id, command_id)) {
+			SaveCommandCache();
+		}
 		m_cluster->guild_command_delete(command_id, guild_id);
 		return true;
 	}
@@ -2384,6 +3447,10 @@ bool DiscordClient::DeleteGlobalCommand(dpp::snowflake command_id)
 	}
 
 	try {
+		LoadCommandCache();
+		if (m_manifest.Remove(0, command_id)) {
+			SaveCommandCache();
+		}
 		m_cluster->global_command_delete(command_id);
 		return true;
 	}
@@ -2400,6 +3467,10 @@ bool DiscordClient::BulkDeleteGuildCommands(dpp::snowflake guild_id)
 	}
 
 	try {
+		LoadCommandCache();
+		if (m_manifest.Clear(guild_id)) {
+			SaveCommandCache();
+		}
 		m_cluster->guild_bulk_command_delete(guild_id);
 		return true;
 	}
@@ -2416,6 +3487,10 @@ bool DiscordClient::BulkDeleteGlobalCommands()
 	}
 
 	try {
+		LoadCommandCache();
+		if (m_manifest.Clear(0)) {
+			SaveCommandCache();
+		}
 		m_cluster->global_bulk_command_delete();
 		return true;
 	}
@@ -2440,8 +3515,8 @@ static cell_t discord_DeleteGuildCommand(IPluginContext* pContext, const cell_t*
 
 	try {
 		dpp::snowflake guild = std::stoull(guildId);
-		dpp::snowflake command = std::stoull(commandId);
-		return discord->DeleteGuildCommand(guild, command) ? 1 : 0;
+		dpp::snowflake command = discord->ResolveCommandId(guild, commandId);
+		return command && discord->DeleteGuildCommand(guild, command) ? 1 : 0;
 	}
 	catch (const std::exception& e) {
 		pContext->ReportError("Invalid ID format");
@@ -2460,8 +3535,8 @@ static cell_t discord_DeleteGlobalCommand(IPluginContext* pContext, const cell_t
 	pContext->LocalToString(params[2], &commandId);
 
 	try {
-		dpp::snowflake command = std::stoull(commandId);
-		return discord->BulkDeleteGuildCommands(command) ? 1 : 0;
+		dpp::snowflake command = discord->ResolveCommandId(0, commandId);
+		return command && discord->DeleteGlobalCommand(command) ? 1 : 0;
 	}
 	catch (const std::exception& e) {
 		pContext->ReportError("Invalid command ID format");
@@ -2505,63 +3580,839 @@ static cell_t discord_BulkDeleteGlobalCommands(IPluginContext* pContext, const c
 	}
 }
 
-const sp_nativeinfo_t discord_natives[] = {
-	// Discord
-	{"Discord.Discord",          discord_CreateClient},
-	{"Discord.Start",            discord_Start},
-	{"Discord.Stop",             discord_Stop},
-	{"Discord.GetBotId",           discord_GetBotId},
-	{"Discord.GetBotName",         discord_GetBotName},
-	{"Discord.GetBotDiscriminator", discord_GetBotDiscriminator},
-	{"Discord.GetBotAvatarUrl",    discord_GetBotAvatarUrl},
-	{"Discord.SetPresence",      discord_SetPresence},
-	{"Discord.CreateWebhook",      discord_CreateWebhook},
-	{"Discord.GetChannelWebhooks",      discord_GetChannelWebhooks},
-	{"Discord.ExecuteWebhook",      discord_ExecuteWebhook},
-	{"Discord.SendMessage",      discord_SendMessage},
-	{"Discord.SendMessageEmbed", discord_SendMessageEmbed},
-	{"Discord.GetChannel", discord_GetChannel},
-	{"Discord.IsRunning",        discord_IsRunning},
-	{"Discord.RegisterSlashCommand", discord_RegisterSlashCommand},
-	{"Discord.RegisterGlobalSlashCommand", discord_RegisterGlobalSlashCommand},
-	{"Discord.EditMessage", discord_EditMessage},
-	{"Discord.EditMessageEmbed", discord_EditMessageEmbed},
-	{"Discord.DeleteMessage", discord_DeleteMessage},
-	{"Discord.RegisterSlashCommandWithOptions", discord_RegisterSlashCommandWithOptions},
-	{"Discord.RegisterGlobalSlashCommandWithOptions", discord_RegisterGlobalSlashCommandWithOptions},
-	{"Discord.DeleteGuildCommand", discord_DeleteGuildCommand},
-	{"Discord.DeleteGlobalCommand", discord_DeleteGlobalCommand},
-	{"Discord.BulkDeleteGuildCommands", discord_BulkDeleteGuildCommands},
-	{"Discord.BulkDeleteGlobalCommands", discord_BulkDeleteGlobalCommands},
-
-	// User
-	{"DiscordUser.GetId",    user_GetId},
-	{"DiscordUser.GetUsername",    user_GetUsername},
-	{"DiscordUser.GetDiscriminator",    user_GetDiscriminator},
-	{"DiscordUser.GetGlobalName",    user_GetGlobalName},
-	{"DiscordUser.GetAvatarUrl",       user_GetAvatarUrl},
-	{"DiscordUser.IsBot",    user_IsBot},
+static cell_t discord_EnableCommandManifest(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordClient* discord = GetDiscordPointer(pContext, params[1]);
+	if (!discord) {
+		return 0;
+	}
 
-	// Message
-	{"DiscordMessage.GetContent",    message_GetContent},
-	{"DiscordMessage.ContentLength.get", message_GetContentLength},
-	{"DiscordMessage.GetMessageId",  message_GetMessageId},
-	{"DiscordMessage.GetChannelId",  message_GetChannelId},
-	{"DiscordMessage.GetGuildId",    message_GetGuildId},
-	{"DiscordMessage.GetAuthor",     message_GetAuthor},
-	{"DiscordMessage.GetAuthorId",   message_GetAuthorId},
-	{"DiscordMessage.GetAuthorName", message_GetAuthorName},
-	{"DiscordMessage.GetAuthorDisplayName", message_GetAuthorDisplayName},
-	{"DiscordMessage.GetAuthorNickname", message_GetAuthorNickname},
-	{"DiscordMessage.GetAuthorDiscriminator", message_GetAuthorDiscriminator},
-	{"DiscordMessage.IsBot",         message_IsBot},
+	cell_t settleMs = params[2];
+	if (settleMs < 0) {
+		pContext->ReportError("Invalid settle time %d", settleMs);
+		return 0;
+	}
 
-	// Channel
-	{"DiscordChannel.GetName",       channel_GetName},
+	discord->EnableCommandManifest(settleMs);
+	return 1;
+}
 
-	// Webhook
-	{"DiscordWebhook.DiscordWebhook",webhook_CreateWebhook},
-	{"DiscordWebhook.GetId",       webhook_GetId},
+static cell_t discord_SyncCommands(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordClient* discord = GetDiscordPointer(pContext, params[1]);
+	if (!discord) {
+		return 0;
+	}
+
+	return discord->SyncCommands(true) ? 1 : 0;
+}
+
+// Message filter natives
+static bool ReadSnowflakeArray(IPluginContext* pContext, cell_t array, cell_t size, std::unordered_set<dpp::snowflake>& out)
+{
+	cell_t* ids_array;
+	pContext->LocalToPhysAddr(array, &ids_array);
+
+	for (cell_t i = 0; i < size; i++) {
+		char* str;
+		pContext->LocalToString(ids_array[i], &str);
+		try {
+			out.insert(std::stoull(str));
+		}
+		catch (const std::exception& e) {
+			pContext->ReportError("Invalid ID format: %s", str);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static cell_t discord_SetMessageFilter(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordClient* discord = GetDiscordPointer(pContext, params[1]);
+	if (!discord) {
+		return 0;
+	}
+
+	auto filter = std::make_shared<MessageFilter>();
+
+	if (!ReadSnowflakeArray(pContext, params[2], params[3], filter->guilds)
+		|| !ReadSnowflakeArray(pContext, params[4], params[5], filter->channels)) {
+		return 0;
+	}
+
+	filter->ignoreBots = params[6] ? true : false;
+	filter->ignoreWebhooks = params[7] ? true : false;
+
+	char* prefix;
+	pContext->LocalToString(params[8], &prefix);
+	filter->prefix = prefix;
+
+	// Keep the pattern rule, it is set through SetMessagePatternFilter
+	if (auto current = discord->GetMessageFilter()) {
+		filter->patterns = current->patterns;
+		filter->deliverMatches = current->deliverMatches;
+	}
+
+	discord->SetMessageFilter(std::move(filter));
+	return 1;
+}
+
+static cell_t discord_ClearMessageFilter(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordClient* discord = GetDiscordPointer(pContext, params[1]);
+	if (!discord) {
+		return 0;
+	}
+
+	discord->SetMessageFilter(nullptr);
+	return 1;
+}
+
+static cell_t discord_GetMessageFilterStats(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordClient* discord = GetDiscordPointer(pContext, params[1]);
+	if (!discord) {
+		return 0;
+	}
+
+	cell_t* passed;
+	cell_t* dropped;
+	pContext->LocalToPhysAddr(params[2], &passed);
+	pContext->LocalToPhysAddr(params[3], &dropped);
+
+	*passed = static_cast<cell_t>(discord->GetFilterPassed());
+	*dropped = static_cast<cell_t>(discord->GetFilterDropped());
+	return 1;
+}
+
+static cell_t discord_RegisterCommandHandler(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordClient* discord = GetDiscordPointer(pContext, params[1]);
+	if (!discord) {
+		return 0;
+	}
+
+	char* path;
+	pContext->LocalToString(params[2], &path);
+	if (!path[0]) {
+		return pContext->ThrowNativeError("Command name must not be empty");
+	}
+
+	IPluginFunction* callback = pContext->GetFunctionById(params[3]);
+	if (!callback) {
+		return pContext->ThrowNativeError("Invalid command handler function %x", params[3]);
+	}
+
+	return g_CommandRouter.Register(discord, path, callback, pContext->GetRuntime(), params[4]) ? 1 : 0;
+}
+
+static cell_t discord_UnregisterCommandHandler(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordClient* discord = GetDiscordPointer(pContext, params[1]);
+	if (!discord) {
+		return 0;
+	}
+
+	char* path;
+	pContext->LocalToString(params[2], &path);
+
+	return g_CommandRouter.Unregister(discord, path, pContext->GetRuntime()) ? 1 : 0;
+}
+
+static DiscordPatternSet* GetPatternSetPointer(IPluginContext* pContext, Handle_t handle)
+{
+	HandleError err;
+	HandleSecurity sec(pContext->GetIdentity(), myself->GetIdentity());
+
+	DiscordPatternSet* set;
+	if ((err = handlesys->ReadHandle(handle, g_DiscordPatternSetHandle, &sec, (void**)&set)) != HandleError_None)
+	{
+		pContext->ThrowNativeError("Invalid Discord pattern set handle %x (error %d)", handle, err);
+		return nullptr;
+	}
+
+	return set;
+}
+
+static cell_t discord_SetMessagePatternFilter(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordClient* discord = GetDiscordPointer(pContext, params[1]);
+	if (!discord) {
+		return 0;
+	}
+
+	std::shared_ptr<const PatternSet> patterns;
+	if (params[2] != BAD_HANDLE) {
+		DiscordPatternSet* set = GetPatternSetPointer(pContext, params[2]);
+		if (!set) {
+			return 0;
+		}
+		patterns = set->GetSet();
+	}
+
+	auto current = discord->GetMessageFilter();
+	auto filter = current ? std::make_shared<MessageFilter>(*current) : std::make_shared<MessageFilter>();
+	filter->patterns = std::move(patterns);
+	filter->deliverMatches = params[3] ? true : false;
+
+	discord->SetMessageFilter(std::move(filter));
+	return 1;
+}
+
+// Pattern set natives
+static cell_t patternset_CreatePatternSet(IPluginContext* pContext, const cell_t* params)
+{
+	if (params[2] < 0) {
+		return pContext->ThrowNativeError("Invalid pattern count %d", params[2]);
+	}
+
+	cell_t* patterns_array;
+	pContext->LocalToPhysAddr(params[1], &patterns_array);
+
+	std::vector<std::string> patterns;
+	patterns.reserve(params[2]);
+	for (cell_t i = 0; i < params[2]; i++) {
+		char* str;
+		pContext->LocalToString(patterns_array[i], &str);
+		patterns.emplace_back(str);
+	}
+
+	DiscordPatternSet* set;
+	try {
+		set = new DiscordPatternSet(std::make_shared<const PatternSet>(patterns, params[3] ? true : false, params[4] ? true : false));
+	}
+	catch (const std::exception& e) {
+		return pContext->ThrowNativeError("Could not build pattern set: %s", e.what());
+	}
+
+	HandleError err;
+	HandleSecurity sec(pContext->GetIdentity(), myself->GetIdentity());
+	Handle_t handle = handlesys->CreateHandleEx(g_DiscordPatternSetHandle, set, &sec, nullptr, &err);
+
+	if (handle == BAD_HANDLE)
+	{
+		delete set;
+		return pContext->ThrowNativeError("Could not create Discord pattern set handle (error %d)", err);
+	}
+
+	return handle;
+}
+
+static cell_t patternset_Match(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordPatternSet* set = GetPatternSetPointer(pContext, params[1]);
+	if (!set) {
+		return 0;
+	}
+
+	char* text;
+	pContext->LocalToString(params[2], &text);
+
+	return set->GetSet()->Matches(text, strlen(text));
+}
+
+static cell_t patternset_FindFirst(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordPatternSet* set = GetPatternSetPointer(pContext, params[1]);
+	if (!set) {
+		return -1;
+	}
+
+	char* text;
+	pContext->LocalToString(params[2], &text);
+
+	size_t start = 0, length = 0;
+	int index = set->GetSet()->FindFirst(text, strlen(text), &start, &length);
+
+	cell_t* startAddr;
+	cell_t* lengthAddr;
+	pContext->LocalToPhysAddr(params[3], &startAddr);
+	pContext->LocalToPhysAddr(params[4], &lengthAddr);
+
+	*startAddr = index != -1 ? static_cast<cell_t>(start) : -1;
+	*lengthAddr = static_cast<cell_t>(length);
+	return index;
+}
+
+static cell_t patternset_CountMatches(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordPatternSet* set = GetPatternSetPointer(pContext, params[1]);
+	if (!set) {
+		return 0;
+	}
+
+	char* text;
+	pContext->LocalToString(params[2], &text);
+
+	return static_cast<cell_t>(set->GetSet()->CountMatches(text, strlen(text)));
+}
+
+static cell_t patternset_GetPatternCount(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordPatternSet* set = GetPatternSetPointer(pContext, params[1]);
+	if (!set) {
+		return 0;
+	}
+
+	return static_cast<cell_t>(set->GetSet()->GetPatternCount());
+}
+
+// Choice set natives
+static DiscordChoiceSet* GetChoiceSetPointer(IPluginContext* pContext, Handle_t handle)
+{
+	HandleError err;
+	HandleSecurity sec(pContext->GetIdentity(), myself->GetIdentity());
+
+	DiscordChoiceSet* choices;
+	if ((err = handlesys->ReadHandle(handle, g_DiscordChoiceSetHandle, &sec, (void**)&choices)) != HandleError_None)
+	{
+		pContext->ThrowNativeError("Invalid Discord choice set handle %x (error %d)", handle, err);
+		return nullptr;
+	}
+
+	return choices;
+}
+
+static cell_t choiceset_CreateChoiceSet(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordChoiceSet* choices = new DiscordChoiceSet();
+
+	HandleError err;
+	HandleSecurity sec(pContext->GetIdentity(), myself->GetIdentity());
+	Handle_t handle = handlesys->CreateHandleEx(g_DiscordChoiceSetHandle, choices, &sec, nullptr, &err);
+
+	if (handle == BAD_HANDLE)
+	{
+		delete choices;
+		return pContext->ThrowNativeError("Could not create Discord choice set handle (error %d)", err);
+	}
+
+	return handle;
+}
+
+static bool ReadChoiceName(IPluginContext* pContext, cell_t param, char** name)
+{
+	pContext->LocalToString(param, name);
+
+	size_t length = strlen(*name);
+	if (length == 0 || length > MAX_CHOICE_NAME_LENGTH) {
+		pContext->ThrowNativeError("Choice name must be 1 to %d characters long", MAX_CHOICE_NAME_LENGTH);
+		return false;
+	}
+
+	return true;
+}
+
+static cell_t choiceset_AddChoice(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordChoiceSet* choices = GetChoiceSetPointer(pContext, params[1]);
+	if (!choices) {
+		return 0;
+	}
+
+	char* name;
+	if (!ReadChoiceName(pContext, params[2], &name)) {
+		return 0;
+	}
+
+	char* value;
+	pContext->LocalToString(params[3], &value);
+
+	choices->AddChoice(name, std::string(value[0] ? value : name));
+	return 1;
+}
+
+static cell_t choiceset_AddChoiceInt(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordChoiceSet* choices = GetChoiceSetPointer(pContext, params[1]);
+	if (!choices) {
+		return 0;
+	}
+
+	char* name;
+	if (!ReadChoiceName(pContext, params[2], &name)) {
+		return 0;
+	}
+
+	choices->AddChoice(name, static_cast<int64_t>(params[3]));
+	return 1;
+}
+
+static cell_t choiceset_Clear(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordChoiceSet* choices = GetChoiceSetPointer(pContext, params[1]);
+	if (!choices) {
+		return 0;
+	}
+
+	choices->Clear();
+	return 1;
+}
+
+static cell_t choiceset_GetCount(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordChoiceSet* choices = GetChoiceSetPointer(pContext, params[1]);
+	if (!choices) {
+		return 0;
+	}
+
+	return static_cast<cell_t>(choices->GetCount());
+}
+
+// Live message natives
+static DiscordLiveMessage* GetLiveMessagePointer(IPluginContext* pContext, Handle_t handle)
+{
+	HandleError err;
+	HandleSecurity sec(pContext->GetIdentity(), myself->GetIdentity());
+
+	DiscordLiveMessage* live;
+	if ((err = handlesys->ReadHandle(handle, g_DiscordLiveMessageHandle, &sec, (void**)&live)) != HandleError_None)
+	{
+		pContext->ThrowNativeError("Invalid Discord live message handle %x (error %d)", handle, err);
+		return nullptr;
+	}
+
+	return live;
+}
+
+static cell_t livemessage_CreateLiveMessage(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordClient* discord = GetDiscordPointer(pContext, params[1]);
+	if (!discord) {
+		return BAD_HANDLE;
+	}
+
+	char* channelId;
+	pContext->LocalToString(params[2], &channelId);
+
+	char* messageId;
+	pContext->LocalToString(params[3], &messageId);
+
+	dpp::snowflake channel, message;
+	try {
+		channel = std::stoull(channelId);
+		message = std::stoull(messageId);
+	}
+	catch (const std::exception& e) {
+		return pContext->ThrowNativeError("Invalid ID format");
+	}
+
+	const int intervalMs = params[4] > 0 ? params[4] : DEFAULT_LIVE_MESSAGE_INTERVAL_MS;
+	DiscordLiveMessage* live = new DiscordLiveMessage(discord->GetLiveMessage(channel, message, intervalMs));
+
+	HandleError err;
+	HandleSecurity sec(pContext->GetIdentity(), myself->GetIdentity());
+	Handle_t handle = handlesys->CreateHandleEx(g_DiscordLiveMessageHandle, live, &sec, nullptr, &err);
+
+	if (handle == BAD_HANDLE)
+	{
+		delete live;
+		return pContext->ThrowNativeError("Could not create Discord live message handle (error %d)", err);
+	}
+
+	return handle;
+}
+
+static cell_t livemessage_Update(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordLiveMessage* live = GetLiveMessagePointer(pContext, params[1]);
+	if (!live) {
+		return 0;
+	}
+
+	char* content;
+	pContext->LocalToString(params[2], &content);
+
+	std::optional<dpp::embed> embed;
+	if (params[3] != BAD_HANDLE) {
+		DiscordEmbed* pEmbed = GetEmbedPointer(pContext, params[3]);
+		if (!pEmbed) {
+			return 0;
+		}
+		embed = pEmbed->GetEmbed();
+	}
+
+	live->m_live->Update(content, std::move(embed));
+	return 1;
+}
+
+static cell_t livemessage_Flush(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordLiveMessage* live = GetLiveMessagePointer(pContext, params[1]);
+	if (!live) {
+		return 0;
+	}
+
+	live->m_live->RequestFlush();
+	return 1;
+}
+
+static cell_t livemessage_GetEditsSent(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordLiveMessage* live = GetLiveMessagePointer(pContext, params[1]);
+	if (!live) {
+		return 0;
+	}
+
+	return static_cast<cell_t>(live->m_live->GetEditsSent());
+}
+
+static cell_t livemessage_GetUpdatesSuperseded(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordLiveMessage* live = GetLiveMessagePointer(pContext, params[1]);
+	if (!live) {
+		return 0;
+	}
+
+	return static_cast<cell_t>(live->m_live->GetUpdatesSuperseded());
+}
+
+static cell_t discord_SetAutocompleteChoices(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordClient* discord = GetDiscordPointer(pContext, params[1]);
+	if (!discord) {
+		return 0;
+	}
+
+	char* command;
+	char* option;
+	pContext->LocalToString(params[2], &command);
+	pContext->LocalToString(params[3], &option);
+
+	std::shared_ptr<const ChoiceIndex> index;
+	if (params[4] != BAD_HANDLE) {
+		DiscordChoiceSet* choices = GetChoiceSetPointer(pContext, params[4]);
+		if (!choices) {
+			return 0;
+		}
+		index = std::make_shared<const ChoiceIndex>(choices->GetChoices());
+	}
+
+	discord->SetChoiceIndex(command, option, std::move(index));
+	return 1;
+}
+
+// Status snapshot natives
+static cell_t discord_SetStatusValue(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordClient* discord = GetDiscordPointer(pContext, params[1]);
+	if (!discord) {
+		return 0;
+	}
+
+	char* key;
+	char* value;
+	pContext->LocalToString(params[2], &key);
+	pContext->LocalToString(params[3], &value);
+
+	discord->GetStatus().Set(key, value);
+	return 1;
+}
+
+static cell_t discord_SetStatusValueInt(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordClient* discord = GetDiscordPointer(pContext, params[1]);
+	if (!discord) {
+		return 0;
+	}
+
+	char* key;
+	pContext->LocalToString(params[2], &key);
+
+	discord->GetStatus().Set(key, std::to_string(params[3]));
+	return 1;
+}
+
+static cell_t discord_RemoveStatusValue(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordClient* discord = GetDiscordPointer(pContext, params[1]);
+	if (!discord) {
+		return 0;
+	}
+
+	char* key;
+	pContext->LocalToString(params[2], &key);
+
+	return discord->GetStatus().Remove(key) ? 1 : 0;
+}
+
+static cell_t discord_PublishStatus(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordClient* discord = GetDiscordPointer(pContext, params[1]);
+	if (!discord) {
+		return 0;
+	}
+
+	discord->GetStatus().Publish();
+	return 1;
+}
+
+static cell_t discord_RegisterStaticResponse(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordClient* discord = GetDiscordPointer(pContext, params[1]);
+	if (!discord) {
+		return 0;
+	}
+
+	char* command;
+	char* content;
+	pContext->LocalToString(params[2], &command);
+	pContext->LocalToString(params[3], &content);
+
+	StaticResponse response;
+	response.content = content;
+	response.ephemeral = params[5] ? true : false;
+
+	if (params[4] != BAD_HANDLE) {
+		DiscordEmbed* embed = GetEmbedPointer(pContext, params[4]);
+		if (!embed) {
+			return 0;
+		}
+		response.embed = embed->GetEmbed();
+	}
+
+	if (response.content.empty() && !response.embed) {
+		return pContext->ThrowNativeError("Static response needs content or an embed");
+	}
+
+	discord->SetStaticResponse(command, std::move(response));
+	return 1;
+}
+
+static cell_t discord_UnregisterStaticResponse(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordClient* discord = GetDiscordPointer(pContext, params[1]);
+	if (!discord) {
+		return 0;
+	}
+
+	char* command;
+	pContext->LocalToString(params[2], &command);
+
+	discord->SetStaticResponse(command, std::nullopt);
+	return 1;
+}
+
+// Coalescing natives
+static cell_t discord_SetChannelCoalescing(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordClient* discord = GetDiscordPointer(pContext, params[1]);
+	if (!discord) {
+		return 0;
+	}
+
+	char* channelId;
+	pContext->LocalToString(params[2], &channelId);
+
+	try {
+		discord->SetChannelCoalescing(std::stoull(channelId), params[3]);
+		return 1;
+	}
+	catch (const std::exception& e) {
+		pContext->ReportError("Invalid channel ID format: %s", channelId);
+		return 0;
+	}
+}
+
+static cell_t discord_SetWebhookCoalescing(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordClient* discord = GetDiscordPointer(pContext, params[1]);
+	if (!discord) {
+		return 0;
+	}
+
+	DiscordWebhook* webhook = GetWebhookPointer(pContext, params[2]);
+	if (!webhook) {
+		return 0;
+	}
+
+	discord->SetWebhookCoalescing(*webhook->m_webhook, params[3]);
+	return 1;
+}
+
+static cell_t discord_FlushCoalescedMessages(IPluginContext* pContext, const cell_t* params)
+{
+	DiscordClient* discord = GetDiscordPointer(pContext, params[1]);
+	if (!discord) {
+		return 0;
+	}
+
+	discord->FlushCoalesced();
+	return 1;
+}
+
+// Auto-defer natives
+static cell_t discord_SetAutoDefer(IPluginContext* pContext, const cell_t* params)
+{
+	if (params[1] < 0) {
+		return pContext->ThrowNativeError("Invalid auto-defer delay %d", params[1]);
+	}
+
+	g_AutoDeferrer.SetDelay(params[1], params[2] ? true : false);
+	return 1;
+}
+
+static cell_t discord_GetAutoDeferredCount(IPluginContext* pContext, const cell_t* params)
+{
+	return static_cast<cell_t>(g_AutoDeferrer.GetAutoDeferred());
+}
+
+static cell_t discord_GetResponseTimeHistogram(IPluginContext* pContext, const cell_t* params)
+{
+	cell_t* counts;
+	pContext->LocalToPhysAddr(params[1], &counts);
+
+	cell_t written = 0;
+	for (size_t i = 0; i < RESPONSE_TIME_BUCKET_COUNT && written < params[2]; i++) {
+		counts[written++] = static_cast<cell_t>(g_AutoDeferrer.GetResponseTimeBucket(i));
+	}
+
+	return written;
+}
+
+static cell_t discord_ResetInteractionStats(IPluginContext* pContext, const cell_t* params)
+{
+	g_AutoDeferrer.ResetStats();
+	return 1;
+}
+
+// Dispatcher natives
+static cell_t discord_SetDispatchBudget(IPluginContext* pContext, const cell_t* params)
+{
+	if (params[1] < 0) {
+		return pContext->ThrowNativeError("Invalid dispatch budget %d", params[1]);
+	}
+
+	g_Dispatcher.SetBudget(params[1]);
+	return 1;
+}
+
+static cell_t discord_GetDispatchStat(IPluginContext* pContext, const cell_t* params)
+{
+	if (params[1] < 0 || params[1] >= DispatchStat_Count) {
+		return pContext->ThrowNativeError("Invalid dispatch stat %d", params[1]);
+	}
+
+	return static_cast<cell_t>(g_Dispatcher.GetStat(static_cast<DispatchStat>(params[1])));
+}
+
+static cell_t discord_GetDispatchLaneStat(IPluginContext* pContext, const cell_t* params)
+{
+	if (params[1] < 0 || params[1] >= TaskLane_Count) {
+		return pContext->ThrowNativeError("Invalid dispatch lane %d", params[1]);
+	}
+
+	if (params[2] < 0 || params[2] >= LaneStat_Count) {
+		return pContext->ThrowNativeError("Invalid dispatch lane stat %d", params[2]);
+	}
+
+	return static_cast<cell_t>(g_Dispatcher.GetLaneStat(static_cast<TaskLane>(params[1]), static_cast<LaneStat>(params[2])));
+}
+
+static cell_t discord_ResetDispatchStats(IPluginContext* pContext, const cell_t* params)
+{
+	g_Dispatcher.ResetStats();
+	return 1;
+}
+
+const sp_nativeinfo_t discord_natives[] = {
+	// Discord
+	{"Discord.Discord",          discord_CreateClient},
+	{"Discord.Start",            discord_Start},
+	{"Discord.Stop",             discord_Stop},
+	{"Discord.GetBotId",           discord_GetBotId},
+	{"Discord.GetBotName",         discord_GetBotName},
+	{"Discord.GetBotDiscriminator", discord_GetBotDiscriminator},
+	{"Discord.GetBotAvatarUrl",    discord_GetBotAvatarUrl},
+	{"Discord.SetPresence",      discord_SetPresence},
+	{"Discord.CreateWebhook",      discord_CreateWebhook},
+	{"Discord.GetChannelWebhooks",      discord_GetChannelWebhooks},
+	{"Discord.ExecuteWebhook",      discord_ExecuteWebhook},
+	{"Discord.SendMessage",      discord_SendMessage},
+	{"Discord.SendMessageEmbed", discord_SendMessageEmbed},
+	{"Discord.GetChannel", discord_GetChannel},
+	{"Discord.IsRunning",        discord_IsRunning},
+	{"Discord.RegisterSlashCommand", discord_RegisterSlashCommand},
+	{"Discord.RegisterGlobalSlashCommand", discord_RegisterGlobalSlashCommand},
+	{"Discord.EditMessage", discord_EditMessage},
+	{"Discord.EditMessageEmbed", discord_EditMessageEmbed},
+	{"Discord.DeleteMessage", discord_DeleteMessage},
+	{"Discord.RegisterSlashCommandWithOptions", discord_RegisterSlashCommandWithOptions},
+	{"Discord.RegisterGlobalSlashCommandWithOptions", discord_RegisterGlobalSlashCommandWithOptions},
+	{"Discord.DeleteGuildCommand", discord_DeleteGuildCommand},
+	{"Discord.DeleteGlobalCommand", discord_DeleteGlobalCommand},
+	{"Discord.BulkDeleteGuildCommands", discord_BulkDeleteGuildCommands},
+	{"Discord.BulkDeleteGlobalCommands", discord_BulkDeleteGlobalCommands},
+	{"Discord.EnableCommandManifest", discord_EnableCommandManifest},
+	{"Discord.SyncCommands", discord_SyncCommands},
+	{"Discord.SetMessageFilter", discord_SetMessageFilter},
+	{"Discord.ClearMessageFilter", discord_ClearMessageFilter},
+	{"Discord.GetMessageFilterStats", discord_GetMessageFilterStats},
+	{"Discord.SetMessagePatternFilter", discord_SetMessagePatternFilter},
+	{"Discord.RegisterCommandHandler", discord_RegisterCommandHandler},
+	{"Discord.UnregisterCommandHandler", discord_UnregisterCommandHandler},
+	{"Discord.SetAutocompleteChoices", discord_SetAutocompleteChoices},
+	{"Discord.SetStatusValue", discord_SetStatusValue},
+	{"Discord.SetStatusValueInt", discord_SetStatusValueInt},
+	{"Discord.RemoveStatusValue", discord_RemoveStatusValue},
+	{"Discord.PublishStatus", discord_PublishStatus},
+	{"Discord.SetChannelCoalescing", discord_SetChannelCoalescing},
+	{"Discord.SetWebhookCoalescing", discord_SetWebhookCoalescing},
+	{"Discord.FlushCoalescedMessages", discord_FlushCoalescedMessages},
+	{"Discord.RegisterStaticResponse", discord_RegisterStaticResponse},
+	{"Discord.UnregisterStaticResponse", discord_UnregisterStaticResponse},
+	{"Discord.SetDispatchBudget", discord_SetDispatchBudget},
+	{"Discord.GetDispatchStat", discord_GetDispatchStat},
+	{"Discord.GetDispatchLaneStat", discord_GetDispatchLaneStat},
+	{"Discord.ResetDispatchStats", discord_ResetDispatchStats},
+	{"Discord.SetAutoDefer", discord_SetAutoDefer},
+	{"Discord.GetAutoDeferredCount", discord_GetAutoDeferredCount},
+	{"Discord.GetResponseTimeHistogram", discord_GetResponseTimeHistogram},
+	{"Discord.ResetInteractionStats", discord_ResetInteractionStats},
+
+	// User
+	{"DiscordUser.GetId",    user_GetId},
+	{"DiscordUser.GetUsername",    user_GetUsername},
+	{"DiscordUser.GetDiscriminator",    user_GetDiscriminator},
+	{"DiscordUser.GetGlobalName",    user_GetGlobalName},
+	{"DiscordUser.GetAvatarUrl",       user_GetAvatarUrl},
+	{"DiscordUser.IsBot",    user_IsBot},
+
+	// Message
+	{"DiscordMessage.GetContent",    message_GetContent},
+	{"DiscordMessage.ContentLength.get", message_GetContentLength},
+	{"DiscordMessage.GetMessageId",  message_GetMessageId},
+	{"DiscordMessage.GetChannelId",  message_GetChannelId},
+	{"DiscordMessage.GetGuildId",    message_GetGuildId},
+	{"DiscordMessage.GetAuthor",     message_GetAuthor},
+	{"DiscordMessage.GetAuthorId",   message_GetAuthorId},
+	{"DiscordMessage.GetAuthorName", message_GetAuthorName},
+	{"DiscordMessage.GetAuthorDisplayName", message_GetAuthorDisplayName},
+	{"DiscordMessage.GetAuthorNickname", message_GetAuthorNickname},
+	{"DiscordMessage.GetAuthorDiscriminator", message_GetAuthorDiscriminator},
+	{"DiscordMessage.IsBot",         message_IsBot},
+	{"DiscordMessage.Retain",        message_Retain},
+
+	// Message batch
+	{"DiscordMessageBatch.Count.get",      batch_GetCount},
+	{"DiscordMessageBatch.GetMessage",     batch_GetMessage},
+	{"DiscordMessageBatch.GetContent",     batch_GetContent},
+	{"DiscordMessageBatch.GetMessageId",   batch_GetMessageId},
+	{"DiscordMessageBatch.GetChannelId",   batch_GetChannelId},
+	{"DiscordMessageBatch.GetGuildId",     batch_GetGuildId},
+	{"DiscordMessageBatch.GetAuthorId",    batch_GetAuthorId},
+	{"DiscordMessageBatch.GetAuthorName",  batch_GetAuthorName},
+	{"DiscordMessageBatch.GetAuthorDisplayName", batch_GetAuthorDisplayName},
+	{"DiscordMessageBatch.IsBot",          batch_IsBot},
+
+	// Channel
+	{"DiscordChannel.GetName",       channel_GetName},
+
+	// Webhook
+	{"DiscordWebhook.DiscordWebhook",webhook_CreateWebhook},
+	{"DiscordWebhook.GetId",       webhook_GetId},
 	{"DiscordWebhook.GetUser",       webhook_GetUser},
 	{"DiscordWebhook.GetName",       webhook_GetName},
 	{"DiscordWebhook.SetName",       webhook_SetName},
@@ -2582,6 +4433,25 @@ const sp_nativeinfo_t discord_natives[] = {
 	{"DiscordEmbed.SetThumbnail", embed_SetThumbnail},
 	{"DiscordEmbed.SetImage",     embed_SetImage},
 
+	// Pattern set
+	{"DiscordPatternSet.DiscordPatternSet", patternset_CreatePatternSet},
+	{"DiscordPatternSet.Match",      patternset_Match},
+	{"DiscordPatternSet.FindFirst",  patternset_FindFirst},
+	{"DiscordPatternSet.CountMatches", patternset_CountMatches},
+	{"DiscordPatternSet.PatternCount.get", patternset_GetPatternCount},
+
+	// Choice set
+	{"DiscordChoiceSet.DiscordChoiceSet", choiceset_CreateChoiceSet},
+	{"DiscordChoiceSet.AddChoice",    choiceset_AddChoice},
+	{"DiscordChoiceSet.AddChoiceInt", choiceset_AddChoiceInt},
+	{"DiscordChoiceSet.Clear",        choiceset_Clear},
+	{"DiscordChoiceSet.Count.get",    choiceset_GetCount},
+	{"DiscordLiveMessage.DiscordLiveMessage", livemessage_CreateLiveMessage},
+	{"DiscordLiveMessage.Update",     livemessage_Update},
+	{"DiscordLiveMessage.Flush",      livemessage_Flush},
+	{"DiscordLiveMessage.EditsSent.get", livemessage_GetEditsSent},
+	{"DiscordLiveMessage.UpdatesSuperseded.get", livemessage_GetUpdatesSuperseded},
+
 	// Slash Command
 	{"DiscordInteraction.CreateResponse", interaction_CreateResponse},
 	{"DiscordInteraction.CreateResponseEmbed", interaction_CreateResponseEmbed},
@@ -2589,6 +4459,12 @@ const sp_nativeinfo_t discord_natives[] = {
 	{"DiscordInteraction.GetOptionValueInt", interaction_GetOptionValueInt},
 	{"DiscordInteraction.GetOptionValueFloat", interaction_GetOptionValueFloat},
 	{"DiscordInteraction.GetOptionValueBool", interaction_GetOptionValueBool},
+	{"DiscordInteraction.OptionCount.get", interaction_GetOptionCount},
+	{"DiscordInteraction.FindOption", interaction_FindOption},
+	{"DiscordInteraction.GetOptionName", interaction_GetOptionName},
+	{"DiscordInteraction.GetOptionType", interaction_GetOptionType},
+	{"DiscordInteraction.GetOptionValueAt", interaction_GetOptionValueAt},
+	{"DiscordInteraction.GetSubcommandPath", interaction_GetSubcommandPath},
 	{"DiscordInteraction.DeferReply", interaction_DeferReply},
 	{"DiscordInteraction.EditResponse", interaction_EditResponse},
 	{"DiscordInteraction.CreateEphemeralResponse", interaction_CreateEphemeralResponse},
@@ -2597,6 +4473,7 @@ const sp_nativeinfo_t discord_natives[] = {
 	{"DiscordInteraction.GetGuildId", interaction_GetGuildId},
 	{"DiscordInteraction.GetChannelId", interaction_GetChannelId},
 	{"DiscordInteraction.GetUser",       interaction_GetUser},
+	{"DiscordInteraction.Retain",        interaction_Retain},
 	{"DiscordInteraction.GetUserNickname", interaction_GetUserNickname},
 	{"DiscordInteraction.GetUserId", interaction_GetUserId},
 	{"DiscordInteraction.GetUserName", interaction_GetUserName},
@@ -2611,6 +4488,8 @@ const sp_nativeinfo_t discord_natives[] = {
 	{"DiscordAutocompleteInteraction.GetOptionValueInt", autocomplete_GetOptionValueInt},
 	{"DiscordAutocompleteInteraction.GetOptionValueFloat", autocomplete_GetOptionValueFloat},
 	{"DiscordAutocompleteInteraction.GetOptionValueBool", autocomplete_GetOptionValueBool},
+	{"DiscordAutocompleteInteraction.GetFocusedOptionName", autocomplete_GetFocusedOptionName},
+	{"DiscordAutocompleteInteraction.GetFocusedOptionValue", autocomplete_GetFocusedOptionValue},
 	{"DiscordAutocompleteInteraction.CreateAutocompleteResponse", autocomplete_CreateAutocompleteResponse},
 	{"DiscordAutocompleteInteraction.AddAutocompleteChoice", autocomplete_AddAutocompleteChoice},
 	{"DiscordAutocompleteInteraction.AddAutocompleteChoiceString", autocomplete_AddAutocompleteChoiceString},
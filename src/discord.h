@@ -30,50 +30,169 @@ public:
 	const dpp::embed& GetEmbed() const { return m_embed; }
 };
 
+class DiscordPatternSet
+{
+private:
+	std::shared_ptr<const PatternSet> m_set;
+
+public:
+	DiscordPatternSet(std::shared_ptr<const PatternSet> set) : m_set(std::move(set)) {}
+
+	const std::shared_ptr<const PatternSet>& GetSet() const { return m_set; }
+};
+
 class DiscordUser
 {
 private:
-	dpp::user m_user;
+	std::shared_ptr<const dpp::user> m_user;
 
 public:
-	DiscordUser(const dpp::user& user) : m_user(user) {}
+	DiscordUser(const dpp::user& user) : m_user(std::make_shared<const dpp::user>(user)) {}
+
+	/**
+	 * @brief Borrows a user from a shared parent object, without copying it.
+	 */
+	DiscordUser(std::shared_ptr<const dpp::user> user) : m_user(std::move(user)) {}
 
-	std::string GetId() const { return std::to_string(m_user.id); }
+	std::string GetId() const { return std::to_string(m_user->id); }
 
-	const char* GetUsername() const { return m_user.username.c_str(); }
+	const char* GetUsername() const { return m_user->username.c_str(); }
 
-	const uint16_t GetDiscriminator() const { return m_user.discriminator; }
+	const uint16_t GetDiscriminator() const { return m_user->discriminator; }
 
-	const char* GetGlobalName() const { return m_user.global_name.c_str(); }
+	const char* GetGlobalName() const { return m_user->global_name.c_str(); }
 
-	std::string GetAvatarUrl(bool prefer_animated_avatars) const { return m_user.get_avatar_url(0, dpp::i_png, prefer_animated_avatars); }
+	std::string GetAvatarUrl(bool prefer_animated_avatars) const { return m_user->get_avatar_url(0, dpp::i_png, prefer_animated_avatars); }
 
-	bool IsBot() const { return m_user.is_bot(); }
+	bool IsBot() const { return m_user->is_bot(); }
 };
 
+/**
+ * @brief Compact snapshot of the message fields the natives read.
+ * 
+ * Built on the gateway thread instead of copying the whole dpp::message
+ * with its embeds, attachments, components and member object. IDs and
+ * flags are kept as integers and every string shares one buffer. The
+ * author's dpp::user is only rebuilt when a plugin asks for it.
+ * 
+ * Immutable once built and shared by every handle referring to the same
+ * message.
+ */
+class MessageSnapshot
+{
+private:
+	enum StringField
+	{
+		StringField_Content = 0,
+		StringField_AuthorName,
+		StringField_AuthorGlobalName,
+		StringField_AuthorNickname,
+		StringField_Count
+	};
+
+	std::string m_strings;					// NUL-separated string fields
+	uint32_t m_offsets[StringField_Count];	// start of each field in m_strings
+	uint32_t m_contentLength;
+
+	dpp::snowflake m_id;
+	dpp::snowflake m_channelId;
+	dpp::snowflake m_guildId;
+	dpp::snowflake m_authorId;
+	dpp::utility::iconhash m_authorAvatar;
+	uint32_t m_authorFlags;
+	uint16_t m_authorDiscriminator;
+	bool m_pinned;
+	bool m_tts;
+	bool m_mentionEveryone;
+
+	// Built on the first GetAuthor call, main thread only
+	mutable std::shared_ptr<const dpp::user> m_author;
+
+	const char* GetString(StringField field) const { return m_strings.c_str() + m_offsets[field]; }
+
+public:
+	MessageSnapshot(const dpp::message& msg);
+
+	std::shared_ptr<const dpp::user> GetAuthor() const;
+	const char* GetContent() const { return GetString(StringField_Content); }
+	const size_t GetContentLength() const { return m_contentLength; }
+	std::string GetMessageId() const { return std::to_string(m_id); }
+	std::string GetChannelId() const { return std::to_string(m_channelId); }
+	std::string GetGuildId() const { return std::to_string(m_guildId); }
+	std::string GetAuthorId() const { return std::to_string(m_authorId); }
+	const char* GetAuthorName() const { return GetString(StringField_AuthorName); }
+	const char* GetAuthorDisplayName() const { return GetString(StringField_AuthorGlobalName); }
+	std::string GetAuthorNickname() const { return GetString(StringField_AuthorNickname); }
+	const uint16_t GetAuthorDiscriminator() const { return m_authorDiscriminator; }
+	bool IsPinned() const { return m_pinned; }
+	bool IsTTS() const { return m_tts; }
+	bool IsMentionEveryone() const { return m_mentionEveryone; }
+	bool IsBot() const { return (m_authorFlags & dpp::u_bot) != 0; }
+};
+
+/**
+ * @brief Handle object of a message, copies share the same snapshot.
+ */
 class DiscordMessage
 {
 private:
-	dpp::message m_message;
+	std::shared_ptr<const MessageSnapshot> m_snapshot;
+
+public:
+	DiscordMessage(const dpp::message& msg) : m_snapshot(std::make_shared<const MessageSnapshot>(msg)) {}
+
+	DiscordUser* GetAuthor() const;
+	const char* GetContent() const { return m_snapshot->GetContent(); }
+	const size_t GetContentLength() const { return m_snapshot->GetContentLength(); }
+	std::string GetMessageId() const { return m_snapshot->GetMessageId(); }
+	std::string GetChannelId() const { return m_snapshot->GetChannelId(); }
+	std::string GetGuildId() const { return m_snapshot->GetGuildId(); }
+	std::string GetAuthorId() const { return m_snapshot->GetAuthorId(); }
+	const char* GetAuthorName() const { return m_snapshot->GetAuthorName(); }
+	const char* GetAuthorDisplayName() const { return m_snapshot->GetAuthorDisplayName(); }
+	std::string GetAuthorNickname() const { return m_snapshot->GetAuthorNickname(); }
+	const uint16_t GetAuthorDiscriminator() const { return m_snapshot->GetAuthorDiscriminator(); }
+	bool IsPinned() const { return m_snapshot->IsPinned(); }
+	bool IsTTS() const { return m_snapshot->IsTTS(); }
+	bool IsMentionEveryone() const { return m_snapshot->IsMentionEveryone(); }
+	bool IsBot() const { return m_snapshot->IsBot(); }
+};
+
+class DiscordChoiceSet
+{
+private:
+	std::vector<AutocompleteChoice> m_choices;
 
 public:
-	DiscordMessage(const dpp::message& msg) : m_message(msg) {}
-
-	DiscordUser* GetAuthor() const { return new DiscordUser(m_message.author); }
-	const char* GetContent() const { return m_message.content.c_str(); }
-	const size_t GetContentLength() const { return m_message.content.length(); }
-	std::string GetMessageId() const { return std::to_string(m_message.id); }
-	std::string GetChannelId() const { return std::to_string(m_message.channel_id); }
-	std::string GetGuildId() const { return std::to_string(m_message.guild_id); }
-	std::string GetAuthorId() const { return std::to_string(m_message.author.id); }
-	const char* GetAuthorName() const { return m_message.author.username.c_str(); }
-	const char* GetAuthorDisplayName() const { return m_message.author.global_name.c_str(); }
-	std::string GetAuthorNickname() const { return m_message.member.get_nickname(); }
-	const uint16_t GetAuthorDiscriminator() const { return m_message.author.discriminator; }
-	bool IsPinned() const { return m_message.pinned; }
-	bool IsTTS() const { return m_message.tts; }
-	bool IsMentionEveryone() const { return m_message.mention_everyone; }
-	bool IsBot() const { return m_message.author.is_bot(); }
+	DiscordChoiceSet() {}
+
+	void AddChoice(const char* name, dpp::command_value value) {
+		m_choices.push_back(AutocompleteChoice{name, std::string(), std::move(value)});
+	}
+	void Clear() { m_choices.clear(); }
+	size_t GetCount() const { return m_choices.size(); }
+	const std::vector<AutocompleteChoice>& GetChoices() const { return m_choices; }
+};
+
+class DiscordLiveMessage
+{
+public:
+	std::shared_ptr<LiveMessage> m_live;
+
+	DiscordLiveMessage(std::shared_ptr<LiveMessage> live) : m_live(std::move(live)) {}
+};
+
+class DiscordMessageBatch
+{
+private:
+	std::vector<DiscordMessage> m_messages;
+
+public:
+	DiscordMessageBatch(std::vector<DiscordMessage>&& messages) : m_messages(std::move(messages)) {}
+
+	size_t GetCount() const { return m_messages.size(); }
+	bool IsValidIndex(cell_t index) const { return index >= 0 && static_cast<size_t>(index) < m_messages.size(); }
+	const DiscordMessage& GetMessage(size_t index) const { return m_messages[index]; }
 };
 
 class DiscordChannel
@@ -90,30 +209,31 @@ public:
 class DiscordWebhook
 {
 public:
-	dpp::webhook m_webhook;
-	DiscordWebhook(const dpp::webhook& wbhk) : m_webhook(wbhk) {}
+	std::shared_ptr<dpp::webhook> m_webhook;
+	DiscordWebhook(const dpp::webhook& wbhk) : m_webhook(std::make_shared<dpp::webhook>(wbhk)) {}
 
-	std::string GetId() const { return std::to_string(m_webhook.id); }
+	std::string GetId() const { return std::to_string(m_webhook->id); }
 
-	DiscordUser* GetUser() const { return new DiscordUser(m_webhook.user_obj); }
+	DiscordUser* GetUser() const;
 
-	const char* GetName() const { return m_webhook.name.c_str(); }
+	const char* GetName() const { return m_webhook->name.c_str(); }
 
-	void SetName(const char* value) { m_webhook.name = value; }
+	void SetName(const char* value) { m_webhook->name = value; }
 
-	const char* GetAvatarUrl() const { return m_webhook.avatar_url.c_str(); }
+	const char* GetAvatarUrl() const { return m_webhook->avatar_url.c_str(); }
 
-	void SetAvatarUrl(const char* value) { m_webhook.avatar_url = value; }
+	void SetAvatarUrl(const char* value) { m_webhook->avatar_url = value; }
 
-	std::string GetAvatarData() const { return m_webhook.avatar.to_string(); }
+	std::string GetAvatarData() const { return m_webhook->avatar.to_string(); }
 
-	void SetAvatarData(const char* value) { m_webhook.avatar = dpp::utility::iconhash(value); }
+	void SetAvatarData(const char* value) { m_webhook->avatar = dpp::utility::iconhash(value); }
 };
 
-class DiscordClient
+class DiscordClient : public IDispatchListener
 {
 private:
-	std::unique_ptr<dpp::cluster> m_cluster;
+	// Shared so interaction snapshots can tell when the client stopped
+	std::shared_ptr<dpp::cluster> m_cluster;
 	bool m_isRunning;
 	Handle_t m_discord_handle;
 	std::unique_ptr<std::thread> m_thread;
@@ -123,8 +243,53 @@ private:
 	std::string m_botDiscriminator;
 	std::string m_botAvatarUrl;
 
+	std::shared_ptr<const MessageFilter> m_messageFilter;
+	std::atomic<uint64_t> m_filterPassed;
+	std::atomic<uint64_t> m_filterDropped;
+
+	// Messages gathered for Discord_OnMessageBatch during the current dispatch pass
+	std::vector<DiscordMessage> m_pendingBatch;
+
+	// Replaced as a whole on the main thread, read by DPP threads
+	std::shared_ptr<const ChoiceIndexMap> m_choiceIndexes;
+	std::shared_ptr<const StaticResponseMap> m_staticResponses;
+
+	StatusStore m_status;
+
+	// Opt-in merging of relay traffic, keyed by channel and webhook ID
+	MessageCoalescer m_channelCoalescer;
+	MessageCoalescer m_webhookCoalescer;
+	std::unordered_map<dpp::snowflake, dpp::webhook> m_coalescedWebhooks;
+
+	// Coalesced sends still in the REST queue, waited for before the cluster shuts down
+	std::mutex m_coalescedMutex;
+	std::condition_variable m_coalescedDone;
+	int m_coalescedInFlight = 0;
+
+	// Keyed by message ID, an entry is dropped once no handle refers to it and nothing is pending
+	LiveMessageMap m_liveMessages;
+
+	// Registrations collected once EnableCommandManifest was called
+	CommandManifest m_manifest;
+	bool m_commandCacheLoaded = false;
+
 	void RunBot();
 	void SetupEventHandlers();
+	bool PassesMessageFilter(const dpp::message& msg);
+	bool AnswerAutocomplete(const dpp::autocomplete_t& event, const OptionIndex& options);
+	bool AnswerStaticResponse(const dpp::slashcommand_t& event);
+	dpp::command_completion_event_t MakeSendCallback(IChangeableForward* callback_forward, cell_t data);
+	void SendCoalescedMessage(dpp::snowflake channel_id, const std::string& content, const AllowedMentions& mentions);
+	void SendCoalescedWebhook(dpp::snowflake webhook_id, const std::string& content, const AllowedMentions& mentions);
+	dpp::command_completion_event_t TrackCoalescedSend();
+	void OnCoalescedSendDone();
+	bool WaitForCoalescedSends(std::chrono::milliseconds timeout);
+	void CreateCommand(const dpp::slashcommand& command, dpp::snowflake guild_id);
+	void SyncCommandScope(dpp::snowflake guild_id);
+	void FinishCommandSync(dpp::snowflake guild_id, bool success, uint64_t hash, const CommandSyncResult& result, std::optional<CommandManifest::CommandIdMap> ids);
+	bool BuildCommandCachePath(char* buffer, size_t maxlength);
+	void LoadCommandCache();
+	void SaveCommandCache();
 
 public:
 	DiscordClient(const char* token);
@@ -137,9 +302,12 @@ public:
 	void SetHandle(Handle_t handle) { m_discord_handle = handle; }
 	bool SetPresence(dpp::presence presence);
 	bool CreateWebhook(dpp::webhook wh, IForward *callback_forward, cell_t data);
-	bool ExecuteWebhook(dpp::webhook wh, const char* message, int allowed_mentions_mask, std::vector<dpp::snowflake> users, std::vector<dpp::snowflake> roles);
-	bool SendMessage(dpp::snowflake channel_id, const char* message, int allowed_mentions_mask, std::vector<dpp::snowflake> users, std::vector<dpp::snowflake> roles);
-	bool SendMessageEmbed(dpp::snowflake channel_id, const char* message, const DiscordEmbed* embed, int allowed_mentions_mask, std::vector<dpp::snowflake> users, std::vector<dpp::snowflake> roles);
+	/**
+	 * @brief Sends a message, callback_forward is optional and released once the result was delivered.
+	 */
+	bool ExecuteWebhook(dpp::webhook wh, const char* message, int allowed_mentions_mask, std::vector<dpp::snowflake> users, std::vector<dpp::snowflake> roles, IChangeableForward* callback_forward = nullptr, cell_t data = 0);
+	bool SendMessage(dpp::snowflake channel_id, const char* message, int allowed_mentions_mask, std::vector<dpp::snowflake> users, std::vector<dpp::snowflake> roles, IChangeableForward* callback_forward = nullptr, cell_t data = 0);
+	bool SendMessageEmbed(dpp::snowflake channel_id, const char* message, const DiscordEmbed* embed, int allowed_mentions_mask, std::vector<dpp::snowflake> users, std::vector<dpp::snowflake> roles, IChangeableForward* callback_forward = nullptr, cell_t data = 0);
 	bool GetChannel(dpp::snowflake channel_id, IForward *callback_forward, cell_t data);
 	bool GetChannelWebhooks(dpp::snowflake channel_id, IForward *callback_forward, cell_t data);
 	bool RegisterSlashCommand(dpp::snowflake guild_id, const char* name, const char* description, const char* default_permissions);
@@ -152,9 +320,72 @@ public:
 	bool DeleteMessage(dpp::snowflake channel_id, dpp::snowflake message_id);
 	bool DeleteGuildCommand(dpp::snowflake guild_id, dpp::snowflake command_id);
 	bool DeleteGlobalCommand(dpp::snowflake command_id);
+	/**
+	 * @brief Parses a command ID, or looks up the ID of a command synced through the manifest by name.
+	 *
+	 * @return The command ID, or 0 if the name is unknown.
+	 */
+	dpp::snowflake ResolveCommandId(dpp::snowflake guild_id, const char* command);
 	bool BulkDeleteGuildCommands(dpp::snowflake guild_id);
 	bool BulkDeleteGlobalCommands();
 
+	void SetMessageFilter(std::shared_ptr<const MessageFilter> filter) { std::atomic_store(&m_messageFilter, std::move(filter)); }
+	std::shared_ptr<const MessageFilter> GetMessageFilter() const { return std::atomic_load(&m_messageFilter); }
+	uint64_t GetFilterPassed() const { return m_filterPassed.load(std::memory_order_relaxed); }
+	uint64_t GetFilterDropped() const { return m_filterDropped.load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief Sets the choices served for an autocomplete option, or removes them if index is null.
+	 */
+	void SetChoiceIndex(const std::string& command, const std::string& option, std::shared_ptr<const ChoiceIndex> index);
+
+	/**
+	 * @brief Answers a command from the status snapshot, or removes the static response if response is empty.
+	 */
+	void SetStaticResponse(const std::string& command, std::optional<StaticResponse> response);
+
+	StatusStore& GetStatus() { return m_status; }
+
+	/**
+	 * @brief Merges messages sent to a channel within windowMs of each other, 0 turns it off.
+	 */
+	void SetChannelCoalescing(dpp::snowflake channel_id, int windowMs);
+
+	/**
+	 * @brief Merges messages executed through a webhook within windowMs of each other, 0 turns it off.
+	 */
+	void SetWebhookCoalescing(const dpp::webhook& wh, int windowMs);
+
+	/**
+	 * @brief Sends every coalesced message right away.
+	 */
+	void FlushCoalesced(bool force = true);
+
+	/**
+	 * @brief Gets the live state of a message, shared with every other caller for the same message.
+	 */
+	std::shared_ptr<LiveMessage> GetLiveMessage(dpp::snowflake channel_id, dpp::snowflake message_id, int intervalMs);
+
+	/**
+	 * @brief Sends the newest state of every live message whose interval has passed.
+	 */
+	void FlushLiveMessages();
+
+	/**
+	 * @brief Collects command registrations in the manifest instead of creating them one by one.
+	 */
+	void EnableCommandManifest(int settleMs);
+
+	/**
+	 * @brief Syncs the manifest scopes that settled, or every changed one if force is set.
+	 *
+	 * @return false if the manifest is not enabled.
+	 */
+	bool SyncCommands(bool force);
+
+	// IDispatchListener
+	void OnDispatchEnd();
+
 	const char* GetBotId() const { return m_botId.c_str(); }
 	const char* GetBotName() const { return m_botName.c_str(); }
 	const char* GetBotDiscriminator() const { return m_botDiscriminator.c_str(); }
@@ -170,141 +401,210 @@ public:
 	}
 };
 
-class DiscordInteraction
+/**
+ * @brief What the natives and replies need from an interaction event.
+ * 
+ * Built on the gateway thread in place of keeping the whole event, which
+ * also carries the raw JSON, the resolved objects and the full member.
+ * Immutable and shared by every handle referring to the interaction.
+ * Retained handles can outlive the client, so replies fail once the
+ * client stopped instead of using its cluster.
+ */
+class InteractionSnapshot
 {
 private:
-	dpp::slashcommand_t m_interaction;
+	std::weak_ptr<dpp::cluster> m_cluster;
+	dpp::snowflake m_id;
+	std::string m_token;
+	dpp::snowflake m_channelId;
+	dpp::snowflake m_guildId;
+	dpp::user m_user;
+	std::string m_nickname;
 	std::string m_commandName;
+	OptionIndex m_options;
 
 public:
-	DiscordInteraction(const dpp::slashcommand_t& interaction) :
-		m_interaction(interaction),
-		m_commandName(interaction.command.get_command_name())
+	InteractionSnapshot(std::weak_ptr<dpp::cluster> cluster, const dpp::interaction& interaction, OptionIndex options) :
+		m_cluster(std::move(cluster)),
+		m_id(interaction.id),
+		m_token(interaction.token),
+		m_channelId(interaction.channel_id),
+		m_guildId(interaction.guild_id),
+		m_user(interaction.usr),
+		m_nickname(interaction.member.get_nickname()),
+		m_commandName(interaction.get_command_name()),
+		m_options(std::move(options))
 	{
 	}
 
+	dpp::snowflake GetId() const { return m_id; }
+	const std::string& GetToken() const { return m_token; }
+	dpp::snowflake GetChannelId() const { return m_channelId; }
+	dpp::snowflake GetGuildId() const { return m_guildId; }
+	const dpp::user& GetUser() const { return m_user; }
+	const std::string& GetNickname() const { return m_nickname; }
 	const char* GetCommandName() const { return m_commandName.c_str(); }
-	std::string GetGuildId() const { return std::to_string(m_interaction.command.guild_id); }
-	std::string GetChannelId() const { return std::to_string(m_interaction.command.channel_id); }
-	DiscordUser* GetUser() const { return new DiscordUser(m_interaction.command.usr); }
-	std::string GetUserId() const { return std::to_string(m_interaction.command.usr.id); }
-	const char* GetUserName() const { return m_interaction.command.usr.username.c_str(); }
-	std::string GetUserNickname() const { return m_interaction.command.member.get_nickname(); }
-
-	bool GetOptionValue(const char* name, std::string& value) const {
-		auto param = m_interaction.get_parameter(name);
-		if (param.index() == 0) return false;
-		value = std::get<std::string>(param);
-		return true;
+	const OptionIndex& GetOptions() const { return m_options; }
+
+	// "name group sub", as used by CommandRouter
+	std::string GetCommandPath() const {
+		std::string path = m_commandName;
+		if (*m_options.GetSubcommandPath()) {
+			path += ' ';
+			path += m_options.GetSubcommandPath();
+		}
+		return path;
 	}
 
-	bool GetOptionValueInt(const char* name, int64_t& value) const {
-		auto param = m_interaction.get_parameter(name);
-		if (param.index() == 0) return false;
-		value = std::get<int64_t>(param);
+	// The reply functions return false if the client was stopped or deleted
+	bool IsClientRunning() const { return !m_cluster.expired(); }
+
+	bool Reply(dpp::interaction_response_type type, const dpp::message& msg) const {
+		std::shared_ptr<dpp::cluster> cluster = m_cluster.lock();
+		if (!cluster) {
+			return false;
+		}
+		cluster->interaction_response_create(m_id, m_token, dpp::interaction_response(type, msg));
 		return true;
 	}
 
-	bool GetOptionValueDouble(const char* name, double& value) const {
-		auto param = m_interaction.get_parameter(name);
-		if (param.index() == 0) return false;
-		value = std::get<double>(param);
-		return true;
+	bool Thinking(bool ephemeral) const {
+		dpp::message msg(m_channelId, "*");
+		msg.guild_id = m_guildId;
+		if (ephemeral) {
+			msg.set_flags(dpp::m_ephemeral);
+		}
+		return Reply(dpp::ir_deferred_channel_message_with_source, msg);
 	}
 
-	bool GetOptionValueBool(const char* name, bool& value) const {
-		auto param = m_interaction.get_parameter(name);
-		if (param.index() == 0) return false;
-		value = std::get<bool>(param);
+	bool EditResponse(const dpp::message& msg) const {
+		std::shared_ptr<dpp::cluster> cluster = m_cluster.lock();
+		if (!cluster) {
+			return false;
+		}
+		cluster->interaction_response_edit(m_token, msg);
 		return true;
 	}
+};
+
+class DiscordInteraction
+{
+private:
+	std::shared_ptr<const InteractionSnapshot> m_interaction;
+	std::shared_ptr<InteractionState> m_state;
 
-	void CreateResponse(const char* content) const {
-		m_interaction.reply(dpp::message(content));
+	// Edits the reply instead if the interaction was already deferred, by the plugin or automatically
+	bool Respond(const dpp::message& msg) const {
+		if (!m_interaction->IsClientRunning()) {
+			return false;
+		}
+		if (m_state->Claim(InteractionReply_Responded)) {
+			return m_interaction->Reply(dpp::ir_channel_message_with_source, msg);
+		}
+		return m_interaction->EditResponse(msg);
 	}
 
-	void CreateResponseEmbed(const char* content, const DiscordEmbed* embed) const {
+public:
+	DiscordInteraction(std::shared_ptr<const InteractionSnapshot> interaction, std::shared_ptr<InteractionState> state) :
+		m_interaction(std::move(interaction)),
+		m_state(std::move(state))
+	{
+	}
+
+	const char* GetCommandName() const { return m_interaction->GetCommandName(); }
+	std::string GetGuildId() const { return std::to_string(m_interaction->GetGuildId()); }
+	std::string GetChannelId() const { return std::to_string(m_interaction->GetChannelId()); }
+	DiscordUser* GetUser() const;
+	std::string GetUserId() const { return std::to_string(m_interaction->GetUser().id); }
+	const char* GetUserName() const { return m_interaction->GetUser().username.c_str(); }
+	std::string GetUserNickname() const { return m_interaction->GetNickname(); }
+
+	const OptionIndex& GetOptions() const { return m_interaction->GetOptions(); }
+
+	bool GetOptionValue(const char* name, std::string& value) const { return GetOptions().GetString(name, value); }
+	bool GetOptionValueInt(const char* name, int64_t& value) const { return GetOptions().GetInt(name, value); }
+	bool GetOptionValueDouble(const char* name, double& value) const { return GetOptions().GetDouble(name, value); }
+	bool GetOptionValueBool(const char* name, bool& value) const { return GetOptions().GetBool(name, value); }
+
+	// The reply functions return false if the client was stopped or deleted
+	bool CreateResponse(const char* content) const {
+		return Respond(dpp::message(content));
+	}
+
+	bool CreateResponseEmbed(const char* content, const DiscordEmbed* embed) const {
 		dpp::message msg(content);
 		msg.add_embed(embed->GetEmbed());
-		m_interaction.reply(msg);
+		return Respond(msg);
 	}
 
-	void DeferReply(bool ephemeral = false) const {
-		m_interaction.thinking(ephemeral);
+	bool DeferReply(bool ephemeral = false) const {
+		if (!m_interaction->IsClientRunning()) {
+			return false;
+		}
+		return !m_state->Claim(InteractionReply_Deferred) || m_interaction->Thinking(ephemeral);
 	}
 
-	void EditResponse(const char* content) const {
-		m_interaction.edit_response(dpp::message(content));
+	bool EditResponse(const char* content) const {
+		return m_interaction->EditResponse(dpp::message(content));
 	}
 
-	void EditResponseEmbed(const char* content, const DiscordEmbed* embed) const {
+	bool EditResponseEmbed(const char* content, const DiscordEmbed* embed) const {
 		dpp::message msg(content);
 		msg.add_embed(embed->GetEmbed());
-		m_interaction.edit_response(msg);
+		return m_interaction->EditResponse(msg);
 	}
 
-	void CreateEphemeralResponse(const char* content) const {
+	bool CreateEphemeralResponse(const char* content) const {
 		dpp::message msg(content);
 		msg.set_flags(dpp::m_ephemeral);
-		m_interaction.reply(msg);
+		return Respond(msg);
 	}
 
-	void CreateEphemeralResponseEmbed(const char* content, const DiscordEmbed* embed) const {
+	bool CreateEphemeralResponseEmbed(const char* content, const DiscordEmbed* embed) const {
 		dpp::message msg(content);
 		msg.set_flags(dpp::m_ephemeral);
 		msg.add_embed(embed->GetEmbed());
-		m_interaction.reply(msg);
+		return Respond(msg);
 	}
 };
 
 class DiscordAutocompleteInteraction
 {
 public:
-	dpp::interaction_response m_response;
-	std::string m_commandName;
-	dpp::interaction m_command;
-	dpp::autocomplete_t m_autocomplete;
-
-	DiscordAutocompleteInteraction(const dpp::autocomplete_t& autocomplete) :
-		m_response(dpp::ir_autocomplete_reply),
-		m_commandName(autocomplete.command.get_command_name()),
-		m_command(autocomplete.command),
-		m_autocomplete(autocomplete)
+	std::vector<dpp::command_option_choice> m_choices;
+	std::shared_ptr<const InteractionSnapshot> m_interaction;
+
+	DiscordAutocompleteInteraction(std::shared_ptr<const InteractionSnapshot> interaction) :
+		m_interaction(std::move(interaction))
 	{
 	}
 
-	const char* GetCommandName() const { return m_commandName.c_str(); }
-	std::string GetGuildId() const { return std::to_string(m_command.guild_id); }
-	std::string GetChannelId() const { return std::to_string(m_command.channel_id); }
-	DiscordUser* GetUser() const { return new DiscordUser(m_command.usr); }
-	std::string GetUserNickname() const { return m_command.member.get_nickname(); }
-
-	dpp::command_option GetOption(const char* name) const {
-		for (auto & opt : m_autocomplete.options) {
-			if (opt.name == name) return opt;
-		}
+	const InteractionSnapshot& GetCommand() const { return *m_interaction; }
 
-		throw std::runtime_error("Option not found");
-	}
-
-	std::string GetOptionValue(const char* name) const {
-		return std::get<std::string>(GetOption(name).value);
-	}
+	const char* GetCommandName() const { return m_interaction->GetCommandName(); }
+	std::string GetGuildId() const { return std::to_string(m_interaction->GetGuildId()); }
+	std::string GetChannelId() const { return std::to_string(m_interaction->GetChannelId()); }
+	DiscordUser* GetUser() const;
+	std::string GetUserNickname() const { return m_interaction->GetNickname(); }
 
-	int64_t GetOptionValueInt(const char* name) const {
-		return std::get<int64_t>(GetOption(name).value);
-	}
+	const OptionIndex& GetOptions() const { return m_interaction->GetOptions(); }
 
-	double GetOptionValueDouble(const char* name) const {
-		return std::get<double>(GetOption(name).value);
-	}
+	bool GetOptionValue(const char* name, std::string& value) const { return GetOptions().GetString(name, value); }
+	bool GetOptionValueInt(const char* name, int64_t& value) const { return GetOptions().GetInt(name, value); }
+	bool GetOptionValueDouble(const char* name, double& value) const { return GetOptions().GetDouble(name, value); }
+	bool GetOptionValueBool(const char* name, bool& value) const { return GetOptions().GetBool(name, value); }
 
-	bool GetOptionValueBool(const char* name) const {
-		return std::get<bool>(GetOption(name).value);
+	void AddAutocompleteOption(dpp::command_option_choice choice) {
+		m_choices.push_back(std::move(choice));
 	}
 
-	void AddAutocompleteOption(dpp::command_option_choice choice) {
-		m_response.add_autocomplete_choice(choice);
+	// The response is only built when it is sent, a dpp::interaction_response is over 1 KB
+	dpp::interaction_response BuildResponse() const {
+		dpp::interaction_response response(dpp::ir_autocomplete_reply);
+		for (const dpp::command_option_choice& choice : m_choices) {
+			response.add_autocomplete_choice(choice);
+		}
+		return response;
 	}
 };
 
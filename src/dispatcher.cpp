@@ -0,0 +1,227 @@
+#include "extension.h"
+
+// Weight of the newest sample in the task cost and wait time moving averages
+#define TASK_COST_SMOOTHING 0.125
+
+TaskQueue g_TaskQueue;
+TaskDispatcher g_Dispatcher;
+
+using dispatch_clock = std::chrono::steady_clock;
+
+TaskDispatcher::TaskDispatcher() :
+	m_budgetUs(DEFAULT_DISPATCH_BUDGET_US),
+	m_avgTaskCostUs(0.0),
+	m_lastFrame(dispatch_clock::now()),
+	m_stalled(false)
+{
+	ResetStats();
+}
+
+void TaskDispatcher::RunTask(TaskLane lane)
+{
+	Lane& l = m_lanes[lane];
+	QueuedTask task = std::move(l.pending.front());
+	l.pending.pop_front();
+
+	const double waitUs = std::chrono::duration<double, std::micro>(dispatch_clock::now() - task.queuedAt).count();
+	l.avgWaitUs += (waitUs - l.avgWaitUs) * TASK_COST_SMOOTHING;
+	if (waitUs > l.maxWaitUs) {
+		l.maxWaitUs = waitUs;
+	}
+	if (m_stalled && waitUs > m_stallMaxWaitUs) {
+		m_stallMaxWaitUs = waitUs;
+	}
+
+	task.func();
+	l.tasksRun++;
+	m_tasksRun++;
+}
+
+void TaskDispatcher::RunFrame()
+{
+	const dispatch_clock::time_point now = dispatch_clock::now();
+	m_frames++;
+
+	// Tasks that waited out a stall are counted by the first frame after it too
+	if (std::chrono::duration<double, std::milli>(now - m_lastFrame).count() >= DISPATCH_STALL_THRESHOLD_MS) {
+		m_stalled = true;
+	}
+	m_lastFrame = now;
+
+	Dispatch();
+	m_stalled = false;
+}
+
+void TaskDispatcher::Pump()
+{
+	const double sinceFrameMs = std::chrono::duration<double, std::milli>(dispatch_clock::now() - m_lastFrame).count();
+	if (sinceFrameMs < DISPATCH_STALL_THRESHOLD_MS) {
+		return;
+	}
+
+	m_stalled = true;
+	m_pumpRuns++;
+	Dispatch();
+}
+
+ResultType TaskDispatcher::OnTimer(ITimer* pTimer, void* pData)
+{
+	Pump();
+	return Pl_Continue;
+}
+
+void TaskDispatcher::OnTimerEnd(ITimer* pTimer, void* pData)
+{
+}
+
+void TaskDispatcher::Dispatch()
+{
+	RunTasks();
+
+	// Indexed, a listener may add or remove listeners while being notified
+	for (size_t i = 0; i < m_listeners.size(); i++) {
+		if (m_listeners[i]) {
+			m_listeners[i]->OnDispatchEnd();
+		}
+	}
+	m_listeners.erase(std::remove(m_listeners.begin(), m_listeners.end(), nullptr), m_listeners.end());
+}
+
+void TaskDispatcher::RemoveListener(IDispatchListener* listener)
+{
+	// Cleared rather than erased so a running notification loop stays valid
+	std::replace(m_listeners.begin(), m_listeners.end(), listener, static_cast<IDispatchListener*>(nullptr));
+}
+
+void TaskDispatcher::RunTasks()
+{
+	Lane& interactions = m_lanes[TaskLane_Interaction];
+	MpscQueue<QueuedTask>& interactionQueue = g_TaskQueue.GetLane(TaskLane_Interaction);
+
+	const dispatch_clock::time_point start = dispatch_clock::now();
+	bool ranAny = false;
+
+	// Interactions are deadline bound and bypass the budget entirely
+	interactionQueue.Drain(interactions.pending);
+	while (!interactions.pending.empty()) {
+		RunTask(TaskLane_Interaction);
+		ranAny = true;
+		interactionQueue.Drain(interactions.pending);
+	}
+
+	for (int lane = TaskLane_Interaction + 1; lane < TaskLane_Count; lane++) {
+		g_TaskQueue.GetLane(static_cast<TaskLane>(lane)).Drain(m_lanes[lane].pending);
+	}
+
+	dispatch_clock::time_point taskStart = dispatch_clock::now();
+	double elapsedUs = std::chrono::duration<double, std::micro>(taskStart - start).count();
+
+	for (int lane = TaskLane_Interaction + 1; lane < TaskLane_Count; lane++) {
+		Lane& l = m_lanes[lane];
+		while (!l.pending.empty()) {
+			if (ranAny && elapsedUs + m_avgTaskCostUs > m_budgetUs) {
+				m_budgetExhausted++;
+				return;
+			}
+
+			RunTask(static_cast<TaskLane>(lane));
+			ranAny = true;
+
+			const dispatch_clock::time_point now = dispatch_clock::now();
+			const double costUs = std::chrono::duration<double, std::micro>(now - taskStart).count();
+			m_avgTaskCostUs += (costUs - m_avgTaskCostUs) * TASK_COST_SMOOTHING;
+			elapsedUs = std::chrono::duration<double, std::micro>(now - start).count();
+			taskStart = now;
+
+			// An interaction that arrived meanwhile jumps ahead of the remaining traffic
+			interactionQueue.Drain(interactions.pending);
+			while (!interactions.pending.empty()) {
+				RunTask(TaskLane_Interaction);
+				interactionQueue.Drain(interactions.pending);
+				taskStart = dispatch_clock::now();
+			}
+		}
+	}
+}
+
+void TaskDispatcher::Clear()
+{
+	g_TaskQueue.Clear();
+
+	for (Lane& l : m_lanes) {
+		l.pending.clear();
+	}
+}
+
+void TaskDispatcher::ResetStats()
+{
+	m_frames = 0;
+	m_budgetExhausted = 0;
+	m_tasksRun = 0;
+	m_pumpRuns = 0;
+	m_stallMaxWaitUs = 0.0;
+
+	for (Lane& l : m_lanes) {
+		l.tasksRun = 0;
+		l.avgWaitUs = 0.0;
+		l.maxWaitUs = 0.0;
+	}
+}
+
+int64_t TaskDispatcher::GetStat(DispatchStat stat) const
+{
+	switch (stat) {
+		case DispatchStat_Frames:
+			return static_cast<int64_t>(m_frames);
+		case DispatchStat_BudgetExhausted:
+			return static_cast<int64_t>(m_budgetExhausted);
+		case DispatchStat_TasksRun:
+			return static_cast<int64_t>(m_tasksRun);
+		case DispatchStat_Backlog:
+		{
+			size_t backlog = 0;
+			for (const Lane& l : m_lanes) {
+				backlog += l.pending.size();
+			}
+			return static_cast<int64_t>(backlog);
+		}
+		case DispatchStat_AvgTaskCostUs:
+			return static_cast<int64_t>(m_avgTaskCostUs);
+		case DispatchStat_BudgetUs:
+			return m_budgetUs;
+		case DispatchStat_PumpRuns:
+			return static_cast<int64_t>(m_pumpRuns);
+		case DispatchStat_StallMaxWaitUs:
+			return static_cast<int64_t>(m_stallMaxWaitUs);
+		case DispatchStat_TasksInlined:
+			return static_cast<int64_t>(Task::GetAllocStats().inlined.load(std::memory_order_relaxed));
+		case DispatchStat_TasksPooled:
+			return static_cast<int64_t>(Task::GetAllocStats().pooled.load(std::memory_order_relaxed));
+		case DispatchStat_TasksHeapAllocated:
+			return static_cast<int64_t>(Task::GetAllocStats().heap.load(std::memory_order_relaxed));
+		// No longer counted, kept so the values after them stay stable for compiled plugins
+		case DispatchStat_ObjectsAllocated:
+		case DispatchStat_ObjectsReused:
+			return 0;
+		default:
+			return 0;
+	}
+}
+
+int64_t TaskDispatcher::GetLaneStat(TaskLane lane, LaneStat stat) const
+{
+	const Lane& l = m_lanes[lane];
+
+	switch (stat) {
+		case LaneStat_TasksRun:
+			return static_cast<int64_t>(l.tasksRun);
+		case LaneStat_Backlog:
+			return static_cast<int64_t>(l.pending.size());
+		case LaneStat_AvgWaitUs:
+			return static_cast<int64_t>(l.avgWaitUs);
+		case LaneStat_MaxWaitUs:
+			return static_cast<int64_t>(l.maxWaitUs);
+		default:
+			return 0;
+	}
+}
@@ -0,0 +1,188 @@
+#ifndef _INCLUDE_DISPATCHER_H_
+#define _INCLUDE_DISPATCHER_H_
+
+#include "extension.h"
+
+#define DEFAULT_DISPATCH_BUDGET_US 1000
+#define DISPATCH_PUMP_INTERVAL 0.1f
+#define DISPATCH_STALL_THRESHOLD_MS 200
+
+/**
+ * @brief Priority lanes of the main-thread handoff, highest priority first.
+ */
+enum TaskLane
+{
+	TaskLane_Interaction = 0,	// Slash commands and autocomplete, deadline bound
+	TaskLane_Default,			// Ready events and REST callbacks
+	TaskLane_Message,			// Message and log traffic
+	TaskLane_Count
+};
+
+enum DispatchStat
+{
+	DispatchStat_Frames = 0,
+	DispatchStat_BudgetExhausted,
+	DispatchStat_TasksRun,
+	DispatchStat_Backlog,
+	DispatchStat_AvgTaskCostUs,
+	DispatchStat_BudgetUs,
+	DispatchStat_PumpRuns,
+	DispatchStat_StallMaxWaitUs,
+	DispatchStat_TasksInlined,
+	DispatchStat_TasksPooled,
+	DispatchStat_TasksHeapAllocated,
+	DispatchStat_ObjectsAllocated,
+	DispatchStat_ObjectsReused,
+	DispatchStat_Count
+};
+
+enum LaneStat
+{
+	LaneStat_TasksRun = 0,
+	LaneStat_Backlog,
+	LaneStat_AvgWaitUs,
+	LaneStat_MaxWaitUs,
+	LaneStat_Count
+};
+
+struct QueuedTask
+{
+	Task func;
+	std::chrono::steady_clock::time_point queuedAt;
+};
+
+/**
+ * @brief Set of lock-free queues, one per TaskLane, fed by DPP threads.
+ */
+class TaskQueue
+{
+private:
+	MpscQueue<QueuedTask> m_lanes[TaskLane_Count];
+
+public:
+	/**
+	 * @brief Queues a task for the main thread. Safe to call from any thread.
+	 * 
+	 * @param task The task to run.
+	 * @param lane Lane deciding the task's priority.
+	 */
+	void Push(Task task, TaskLane lane = TaskLane_Default) {
+		m_lanes[lane].Push(QueuedTask{std::move(task), std::chrono::steady_clock::now()});
+	}
+
+	/**
+	 * @brief Drops every queued task. Only call from the consumer thread.
+	 */
+	void Clear() {
+		std::deque<QueuedTask> discarded;
+		for (MpscQueue<QueuedTask>& lane : m_lanes) {
+			lane.Drain(discarded);
+		}
+	}
+
+	MpscQueue<QueuedTask>& GetLane(TaskLane lane) { return m_lanes[lane]; }
+};
+
+/**
+ * @brief Notified on the game thread after each dispatch pass.
+ * 
+ * Lets work gathered by the tasks of one pass, such as batched forwards,
+ * be flushed once per frame instead of once per task.
+ */
+class IDispatchListener
+{
+public:
+	virtual ~IDispatchListener() {}
+	virtual void OnDispatchEnd() = 0;
+};
+
+/**
+ * @brief Runs tasks handed over through g_TaskQueue on the game thread.
+ * 
+ * Interaction tasks are always run first and in full. Lower lanes share a
+ * per-frame time budget: the dispatcher keeps a moving average of how long
+ * a task takes and stops before starting one that would likely overrun it.
+ * Tasks taken off the queue but not run are kept for the next frame, never
+ * dropped.
+ * 
+ * When the server hibernates or stalls on a map change no game frames run.
+ * The dispatcher is also a repeating SourceMod timer that notices the
+ * missing frames and keeps draining at one budget per timer tick.
+ */
+class TaskDispatcher : public ITimedEvent
+{
+private:
+	struct Lane {
+		std::deque<QueuedTask> pending;
+		uint64_t tasksRun;
+		double avgWaitUs;
+		double maxWaitUs;
+	};
+
+	Lane m_lanes[TaskLane_Count];
+	int m_budgetUs;
+	double m_avgTaskCostUs;
+
+	uint64_t m_frames;
+	uint64_t m_budgetExhausted;
+	uint64_t m_tasksRun;
+	uint64_t m_pumpRuns;
+	double m_stallMaxWaitUs;
+
+	std::chrono::steady_clock::time_point m_lastFrame;
+	bool m_stalled;
+
+	std::vector<IDispatchListener*> m_listeners;
+
+	void RunTask(TaskLane lane);
+	void RunTasks();
+	void Dispatch();
+
+public:
+	TaskDispatcher();
+
+	/**
+	 * @brief Drains g_TaskQueue and runs pending tasks within the frame budget.
+	 * 
+	 * At least one task runs per call so a single expensive task can not
+	 * stall the queue forever.
+	 */
+	void RunFrame();
+
+	/**
+	 * @brief Drains g_TaskQueue if no game frame has run for a while.
+	 */
+	void Pump();
+
+	// ITimedEvent
+	ResultType OnTimer(ITimer* pTimer, void* pData);
+	void OnTimerEnd(ITimer* pTimer, void* pData);
+
+	void AddListener(IDispatchListener* listener) { m_listeners.push_back(listener); }
+
+	/**
+	 * @brief Unregisters a listener. Safe to call from within OnDispatchEnd.
+	 */
+	void RemoveListener(IDispatchListener* listener);
+
+	/**
+	 * @brief Drops every task that has not run yet.
+	 */
+	void Clear();
+
+	/**
+	 * @brief Resets counters and wait times, keeping pending tasks.
+	 */
+	void ResetStats();
+
+	void SetBudget(int microseconds) { m_budgetUs = microseconds > 0 ? microseconds : DEFAULT_DISPATCH_BUDGET_US; }
+	int GetBudget() const { return m_budgetUs; }
+
+	int64_t GetStat(DispatchStat stat) const;
+	int64_t GetLaneStat(TaskLane lane, LaneStat stat) const;
+};
+
+extern TaskQueue g_TaskQueue;
+extern TaskDispatcher g_Dispatcher;
+
+#endif // _INCLUDE_DISPATCHER_H_
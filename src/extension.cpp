@@ -1,11 +1,9 @@
 #include "extension.h"
 
-#define MAX_PROCESS 10
-
 DiscordExtension g_DiscordExt;
 SMEXT_LINK(&g_DiscordExt);
 
-HandleType_t g_DiscordHandle, g_DiscordUserHandle, g_DiscordMessageHandle, g_DiscordChannelHandle, g_DiscordWebhookHandle, g_DiscordEmbedHandle, g_DiscordInteractionHandle, g_DiscordAutocompleteInteractionHandle;
+HandleType_t g_DiscordHandle, g_DiscordUserHandle, g_DiscordMessageHandle, g_DiscordChannelHandle, g_DiscordWebhookHandle, g_DiscordEmbedHandle, g_DiscordInteractionHandle, g_DiscordAutocompleteInteractionHandle, g_DiscordPatternSetHandle, g_DiscordMessageBatchHandle, g_DiscordChoiceSetHandle, g_DiscordLiveMessageHandle;
 DiscordHandler g_DiscordHandler;
 DiscordUserHandler g_DiscordUserHandler;
 DiscordMessageHandler g_DiscordMessageHandler;
@@ -14,22 +12,24 @@ DiscordWebhookHandler g_DiscordWebhookHandler;
 DiscordEmbedHandler g_DiscordEmbedHandler;
 DiscordInteractionHandler g_DiscordInteractionHandler;
 DiscordAutocompleteInteractionHandler g_DiscordAutocompleteInteractionHandler;
+DiscordPatternSetHandler g_DiscordPatternSetHandler;
+DiscordMessageBatchHandler g_DiscordMessageBatchHandler;
+DiscordChoiceSetHandler g_DiscordChoiceSetHandler;
+DiscordLiveMessageHandler g_DiscordLiveMessageHandler;
 
 IForward* g_pForwardReady = nullptr;
 IForward* g_pForwardMessage = nullptr;
 IForward* g_pForwardError = nullptr;
 IForward* g_pForwardSlashCommand = nullptr;
 IForward* g_pForwardAutocomplete = nullptr;
+IForward* g_pForwardMessageBatch = nullptr;
+IForward* g_pForwardCommandsSynced = nullptr;
 
-ThreadSafeQueue<std::function<void()>> g_TaskQueue;
+static ITimer* g_pDispatchTimer = nullptr;
 
 static void OnGameFrame(bool simulating) {
-	std::function<void()> task;
-	int count = 0;
-	while (g_TaskQueue.TryPop(task) && count < MAX_PROCESS) {
-		task();
-		count++;
-	}
+	g_Subscriptions.Refresh();
+	g_Dispatcher.RunFrame();
 }
 
 bool DiscordExtension::SDK_OnLoad(char* error, size_t maxlen, bool late)
@@ -49,25 +49,39 @@ bool DiscordExtension::SDK_OnLoad(char* error, size_t maxlen, bool late)
 	g_DiscordEmbedHandle = handlesys->CreateType("DiscordEmbed", &g_DiscordEmbedHandler, 0, nullptr, &haDefaults, myself->GetIdentity(), nullptr);
 	g_DiscordInteractionHandle = handlesys->CreateType("DiscordInteraction", &g_DiscordInteractionHandler, 0, nullptr, &haDefaults, myself->GetIdentity(), nullptr);
 	g_DiscordAutocompleteInteractionHandle = handlesys->CreateType("DiscordAutocompleteInteraction", &g_DiscordAutocompleteInteractionHandler, 0, nullptr, &haDefaults, myself->GetIdentity(), nullptr);
+	g_DiscordPatternSetHandle = handlesys->CreateType("DiscordPatternSet", &g_DiscordPatternSetHandler, 0, nullptr, &haDefaults, myself->GetIdentity(), nullptr);
+	g_DiscordMessageBatchHandle = handlesys->CreateType("DiscordMessageBatch", &g_DiscordMessageBatchHandler, 0, nullptr, &haDefaults, myself->GetIdentity(), nullptr);
+	g_DiscordChoiceSetHandle = handlesys->CreateType("DiscordChoiceSet", &g_DiscordChoiceSetHandler, 0, nullptr, &haDefaults, myself->GetIdentity(), nullptr);
+	g_DiscordLiveMessageHandle = handlesys->CreateType("DiscordLiveMessage", &g_DiscordLiveMessageHandler, 0, nullptr, &haDefaults, myself->GetIdentity(), nullptr);
 
 	g_pForwardReady = forwards->CreateForward("Discord_OnReady", ET_Ignore, 1, nullptr, Param_Cell);
 	g_pForwardMessage = forwards->CreateForward("Discord_OnMessage", ET_Ignore, 2, nullptr, Param_Cell, Param_Cell);
 	g_pForwardError = forwards->CreateForward("Discord_OnError", ET_Ignore, 2, nullptr, Param_Cell, Param_String);
 	g_pForwardSlashCommand = forwards->CreateForward("Discord_OnSlashCommand", ET_Ignore, 2, nullptr, Param_Cell, Param_Cell);
 	g_pForwardAutocomplete = forwards->CreateForward("Discord_OnAutocomplete", ET_Ignore, 5, nullptr, Param_Cell, Param_Cell, Param_Cell, Param_Cell, Param_String);
+	g_pForwardMessageBatch = forwards->CreateForward("Discord_OnMessageBatch", ET_Ignore, 2, nullptr, Param_Cell, Param_Cell);
+	g_pForwardCommandsSynced = forwards->CreateForward("Discord_OnCommandsSynced", ET_Ignore, 7, nullptr, Param_Cell, Param_String, Param_Cell, Param_Cell, Param_Cell, Param_Cell, Param_Cell);
+
+	g_Subscriptions.Refresh();
+	plsys->AddPluginsListener(this);
 
 	smutils->AddGameFrameHook(&OnGameFrame);
+	g_pDispatchTimer = timersys->CreateTimer(&g_Dispatcher, DISPATCH_PUMP_INTERVAL, nullptr, TIMER_FLAG_REPEAT);
 
 	return true;
 }
 
 void DiscordExtension::SDK_OnUnload()
 {
+	plsys->RemovePluginsListener(this);
+
 	forwards->ReleaseForward(g_pForwardReady);
 	forwards->ReleaseForward(g_pForwardMessage);
 	forwards->ReleaseForward(g_pForwardError);
 	forwards->ReleaseForward(g_pForwardSlashCommand);
 	forwards->ReleaseForward(g_pForwardAutocomplete);
+	forwards->ReleaseForward(g_pForwardMessageBatch);
+	forwards->ReleaseForward(g_pForwardCommandsSynced);
 
 	handlesys->RemoveType(g_DiscordHandle, myself->GetIdentity());
 	handlesys->RemoveType(g_DiscordUserHandle, myself->GetIdentity());
@@ -77,8 +91,29 @@ void DiscordExtension::SDK_OnUnload()
 	handlesys->RemoveType(g_DiscordEmbedHandle, myself->GetIdentity());
 	handlesys->RemoveType(g_DiscordInteractionHandle, myself->GetIdentity());
 	handlesys->RemoveType(g_DiscordAutocompleteInteractionHandle, myself->GetIdentity());
+	handlesys->RemoveType(g_DiscordPatternSetHandle, myself->GetIdentity());
+	handlesys->RemoveType(g_DiscordMessageBatchHandle, myself->GetIdentity());
+	handlesys->RemoveType(g_DiscordChoiceSetHandle, myself->GetIdentity());
+	handlesys->RemoveType(g_DiscordLiveMessageHandle, myself->GetIdentity());
 
 	smutils->RemoveGameFrameHook(&OnGameFrame);
+	if (g_pDispatchTimer) {
+		timersys->KillTimer(g_pDispatchTimer);
+		g_pDispatchTimer = nullptr;
+	}
+	g_Dispatcher.Clear();
+	g_AutoDeferrer.Shutdown();
+}
+
+void DiscordExtension::OnPluginLoaded(IPlugin* plugin)
+{
+	g_Subscriptions.AddPlugin(plugin);
+}
+
+void DiscordExtension::OnPluginUnloaded(IPlugin* plugin)
+{
+	g_CommandRouter.RemovePlugin(plugin->GetRuntime());
+	g_Subscriptions.Refresh();
 }
 
 void DiscordHandler::OnHandleDestroy(HandleType_t type, void* object)
@@ -128,4 +163,28 @@ void DiscordAutocompleteInteractionHandler::OnHandleDestroy(HandleType_t type, v
 {
 	DiscordAutocompleteInteraction* interaction = (DiscordAutocompleteInteraction*)object;
 	delete interaction;
-}
\ No newline at end of file
+}
+
+void DiscordPatternSetHandler::OnHandleDestroy(HandleType_t type, void* object)
+{
+	DiscordPatternSet* set = (DiscordPatternSet*)object;
+	delete set;
+}
+
+void DiscordMessageBatchHandler::OnHandleDestroy(HandleType_t type, void* object)
+{
+	DiscordMessageBatch* batch = (DiscordMessageBatch*)object;
+	delete batch;
+}
+
+void DiscordChoiceSetHandler::OnHandleDestroy(HandleType_t type, void* object)
+{
+	DiscordChoiceSet* choices = (DiscordChoiceSet*)object;
+	delete choices;
+}
+
+void DiscordLiveMessageHandler::OnHandleDestroy(HandleType_t type, void* object)
+{
+	DiscordLiveMessage* live = (DiscordLiveMessage*)object;
+	delete live;
+}
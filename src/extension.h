@@ -3,17 +3,50 @@
 
 #include "smsdk_ext.h"
 #include <queue>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <functional>
+#include <unordered_set>
+#include <unordered_map>
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
 #include <mutex>
 #include <condition_variable>
+#include <thread>
+#include <optional>
 #include "queue.h"
+#include "task.h"
+#include "dispatcher.h"
+#include "subscriptions.h"
 #include "dpp/dpp.h"
+#include "commandrouter.h"
+#include "patternset.h"
+#include "choiceindex.h"
+#include "optionindex.h"
+#include "autodefer.h"
+#include "statusstore.h"
+#include "coalescer.h"
+#include "livemessage.h"
+#include "commandmanifest.h"
+#include "filter.h"
 #include "discord.h"
 
-class DiscordExtension : public SDKExtension
+class DiscordExtension : public SDKExtension, public IPluginsListener
 {
 public:
 	virtual bool SDK_OnLoad(char* error, size_t maxlength, bool late);
 	virtual void SDK_OnUnload();
+
+	// IPluginsListener
+	virtual void OnPluginLoaded(IPlugin* plugin);
+	virtual void OnPluginUnloaded(IPlugin* plugin);
 };
 
 class DiscordHandler : public IHandleTypeDispatch
@@ -64,16 +97,41 @@ public:
 	void OnHandleDestroy(HandleType_t type, void* object);
 };
 
+class DiscordPatternSetHandler : public IHandleTypeDispatch
+{
+public:
+	void OnHandleDestroy(HandleType_t type, void* object);
+};
+
+class DiscordMessageBatchHandler : public IHandleTypeDispatch
+{
+public:
+	void OnHandleDestroy(HandleType_t type, void* object);
+};
+
+class DiscordChoiceSetHandler : public IHandleTypeDispatch
+{
+public:
+	void OnHandleDestroy(HandleType_t type, void* object);
+};
+
+class DiscordLiveMessageHandler : public IHandleTypeDispatch
+{
+public:
+	void OnHandleDestroy(HandleType_t type, void* object);
+};
+
 extern DiscordExtension g_DiscordExt;
-extern ThreadSafeQueue<std::function<void()>> g_TaskQueue;
 
 extern IForward* g_pForwardReady;
 extern IForward* g_pForwardMessage;
 extern IForward* g_pForwardError;
 extern IForward* g_pForwardSlashCommand;
 extern IForward* g_pForwardAutocomplete;
+extern IForward* g_pForwardMessageBatch;
+extern IForward* g_pForwardCommandsSynced;
 
-extern HandleType_t g_DiscordHandle, g_DiscordUserHandle, g_DiscordMessageHandle, g_DiscordChannelHandle, g_DiscordWebhookHandle, g_DiscordEmbedHandle, g_DiscordInteractionHandle, g_DiscordAutocompleteInteractionHandle;
+extern HandleType_t g_DiscordHandle, g_DiscordUserHandle, g_DiscordMessageHandle, g_DiscordChannelHandle, g_DiscordWebhookHandle, g_DiscordEmbedHandle, g_DiscordInteractionHandle, g_DiscordAutocompleteInteractionHandle, g_DiscordPatternSetHandle, g_DiscordMessageBatchHandle, g_DiscordChoiceSetHandle, g_DiscordLiveMessageHandle;
 extern DiscordHandler g_DiscordHandler;
 extern DiscordUserHandler g_DiscordUserHandler;
 extern DiscordMessageHandler g_DiscordMessageHandler;
@@ -82,6 +140,10 @@ extern DiscordWebhookHandler g_DiscordWebhookHandler;
 extern DiscordEmbedHandler g_DiscordEmbedHandler;
 extern DiscordInteractionHandler g_DiscordInteractionHandler;
 extern DiscordAutocompleteInteractionHandler g_DiscordAutocompleteInteractionHandler;
+extern DiscordPatternSetHandler g_DiscordPatternSetHandler;
+extern DiscordMessageBatchHandler g_DiscordMessageBatchHandler;
+extern DiscordChoiceSetHandler g_DiscordChoiceSetHandler;
+extern DiscordLiveMessageHandler g_DiscordLiveMessageHandler;
 
 extern const sp_nativeinfo_t discord_natives[];
 
@@ -0,0 +1,52 @@
+#ifndef _INCLUDE_FILTER_H_
+#define _INCLUDE_FILTER_H_
+
+#include "extension.h"
+
+/**
+ * @brief Rules deciding which incoming messages reach plugins.
+ * 
+ * Immutable once published to a DiscordClient, so DPP threads can evaluate
+ * it without locking. Empty allowlists, an empty prefix and a missing
+ * pattern set match anything.
+ */
+struct MessageFilter
+{
+	std::unordered_set<dpp::snowflake> guilds;
+	std::unordered_set<dpp::snowflake> channels;
+	bool ignoreBots = false;
+	bool ignoreWebhooks = false;
+	std::string prefix;
+	std::shared_ptr<const PatternSet> patterns;
+	bool deliverMatches = false;
+
+	bool Matches(const dpp::message& msg) const {
+		if (ignoreBots && msg.author.is_bot()) {
+			return false;
+		}
+
+		if (ignoreWebhooks && !msg.webhook_id.empty()) {
+			return false;
+		}
+
+		if (!guilds.empty() && guilds.find(msg.guild_id) == guilds.end()) {
+			return false;
+		}
+
+		if (!channels.empty() && channels.find(msg.channel_id) == channels.end()) {
+			return false;
+		}
+
+		if (!prefix.empty() && msg.content.compare(0, prefix.length(), prefix) != 0) {
+			return false;
+		}
+
+		if (patterns && patterns->Matches(msg.content) != deliverMatches) {
+			return false;
+		}
+
+		return true;
+	}
+};
+
+#endif // _INCLUDE_FILTER_H_
@@ -0,0 +1,32 @@
+#include "extension.h"
+
+dpp::message LiveMessage::TakeEdit()
+{
+	dpp::message msg;
+	msg.id = m_messageId;
+	msg.channel_id = m_channelId;
+	msg.content = m_content;
+	if (m_embed) {
+		msg.add_embed(*m_embed);
+	}
+
+	m_dirty = false;
+	m_flushNow = false;
+	m_lastSent = live_clock::now();
+	m_inFlight = true;
+
+	return msg;
+}
+
+void LiveMessage::OnEditDone(bool success, bool retry)
+{
+	m_inFlight = false;
+
+	if (success) {
+		m_editsSent++;
+	}
+	// The failed state is still the newest one unless Update replaced it meanwhile
+	else if (retry) {
+		m_dirty = true;
+	}
+}
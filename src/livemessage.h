@@ -0,0 +1,80 @@
+#ifndef _INCLUDE_LIVEMESSAGE_H_
+#define _INCLUDE_LIVEMESSAGE_H_
+
+#include "extension.h"
+
+#define DEFAULT_LIVE_MESSAGE_INTERVAL_MS 2000
+
+/**
+ * @brief Latest wanted state of a message that is edited over and over.
+ *
+ * Updates only replace the state. DiscordClient sends at most one edit
+ * per interval, and never while the previous one is still queued, so an
+ * update that is replaced before it is sent never reaches the REST queue.
+ * An edit that fails is sent again, unless a newer update replaced it.
+ * Shared by every plugin editing the same message. Main thread only.
+ */
+class LiveMessage
+{
+private:
+	typedef std::chrono::steady_clock live_clock;
+
+	dpp::snowflake m_channelId;
+	dpp::snowflake m_messageId;
+	int m_intervalMs;
+
+	std::string m_content;
+	std::optional<dpp::embed> m_embed;
+	bool m_dirty = false;
+	bool m_flushNow = false;
+	live_clock::time_point m_lastSent;
+	bool m_inFlight = false;
+
+	uint32_t m_editsSent = 0;
+	uint32_t m_updatesSuperseded = 0;
+
+public:
+	LiveMessage(dpp::snowflake channel_id, dpp::snowflake message_id, int intervalMs) :
+		m_channelId(channel_id), m_messageId(message_id), m_intervalMs(intervalMs) {}
+
+	void SetInterval(int intervalMs) { m_intervalMs = intervalMs; }
+
+	void Update(const char* content, std::optional<dpp::embed> embed) {
+		if (m_dirty) {
+			m_updatesSuperseded++;
+		}
+		m_content = content;
+		m_embed = std::move(embed);
+		m_dirty = true;
+	}
+
+	// Sends the pending state on the next dispatch pass, without waiting for the interval
+	void RequestFlush() { m_flushNow = true; }
+
+	bool IsDue() const {
+		return m_dirty && !m_inFlight
+			&& (m_flushNow || live_clock::now() - m_lastSent >= std::chrono::milliseconds(m_intervalMs));
+	}
+
+	bool IsIdle() const { return !m_dirty && !m_inFlight; }
+
+	/**
+	 * @brief Builds the edit for the pending state and marks it as in flight.
+	 */
+	dpp::message TakeEdit();
+
+	/**
+	 * @brief Ends the edit in flight.
+	 *
+	 * @param retry  Whether a failed edit can succeed when sent again.
+	 */
+	void OnEditDone(bool success, bool retry);
+
+	// Edits Discord accepted
+	uint32_t GetEditsSent() const { return m_editsSent; }
+	uint32_t GetUpdatesSuperseded() const { return m_updatesSuperseded; }
+};
+
+typedef std::unordered_map<dpp::snowflake, std::shared_ptr<LiveMessage>> LiveMessageMap;
+
+#endif // _INCLUDE_LIVEMESSAGE_H_
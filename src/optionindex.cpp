@@ -0,0 +1,161 @@
+#include "extension.h"
+
+// Option is dpp::command_data_option for slash commands, dpp::command_option for autocomplete
+template <typename Option>
+void OptionIndex::Build(const std::vector<Option>& options)
+{
+	// Subcommand groups and subcommands are always the first, and only, option of their parent
+	const std::vector<Option>* level = &options;
+	while (!level->empty()) {
+		const Option& option = level->front();
+		if (option.type != dpp::co_sub_command_group && option.type != dpp::co_sub_command) {
+			break;
+		}
+
+		if (!m_subcommandPath.empty()) {
+			m_subcommandPath += ' ';
+		}
+		m_subcommandPath += option.name;
+		level = &option.options;
+	}
+
+	m_options.reserve(level->size());
+	for (const Option& option : *level) {
+		if (option.focused) {
+			m_focused = static_cast<int>(m_options.size());
+		}
+		m_options.push_back(IndexedOption{option.name, option.type, option.value});
+	}
+
+	m_byName.resize(m_options.size());
+	for (size_t i = 0; i < m_options.size(); i++) {
+		m_byName[i] = static_cast<uint8_t>(i);
+	}
+
+	std::sort(m_byName.begin(), m_byName.end(), [this](uint8_t a, uint8_t b) {
+		return m_options[a].name < m_options[b].name;
+	});
+}
+
+OptionIndex::OptionIndex(const dpp::interaction& interaction)
+{
+	if (const dpp::command_interaction* command = std::get_if<dpp::command_interaction>(&interaction.data)) {
+		Build(command->options);
+	}
+}
+
+OptionIndex::OptionIndex(const std::vector<dpp::command_option>& options)
+{
+	Build(options);
+}
+
+int OptionIndex::Find(const char* name) const
+{
+	auto it = std::lower_bound(m_byName.begin(), m_byName.end(), name, [this](uint8_t index, const char* key) {
+		return strcmp(m_options[index].name.c_str(), key) < 0;
+	});
+
+	if (it == m_byName.end() || m_options[*it].name != name) {
+		return -1;
+	}
+
+	return *it;
+}
+
+bool OptionIndex::ToString(const dpp::command_value& value, std::string& out)
+{
+	if (const std::string* str = std::get_if<std::string>(&value)) {
+		out = *str;
+	}
+	else if (const int64_t* num = std::get_if<int64_t>(&value)) {
+		out = std::to_string(*num);
+	}
+	else if (const dpp::snowflake* id = std::get_if<dpp::snowflake>(&value)) {
+		out = std::to_string(*id);
+	}
+	else if (const double* num = std::get_if<double>(&value)) {
+		char buffer[32];
+		snprintf(buffer, sizeof(buffer), "%g", *num);
+		out = buffer;
+	}
+	else if (const bool* flag = std::get_if<bool>(&value)) {
+		out = *flag ? "true" : "false";
+	}
+	else {
+		return false;
+	}
+
+	return true;
+}
+
+bool OptionIndex::ToInt(const dpp::command_value& value, int64_t& out)
+{
+	if (const int64_t* num = std::get_if<int64_t>(&value)) {
+		out = *num;
+	}
+	else if (const double* num = std::get_if<double>(&value)) {
+		out = static_cast<int64_t>(*num);
+	}
+	else if (const bool* flag = std::get_if<bool>(&value)) {
+		out = *flag ? 1 : 0;
+	}
+	else {
+		return false;
+	}
+
+	return true;
+}
+
+bool OptionIndex::ToDouble(const dpp::command_value& value, double& out)
+{
+	if (const double* num = std::get_if<double>(&value)) {
+		out = *num;
+	}
+	else if (const int64_t* num = std::get_if<int64_t>(&value)) {
+		out = static_cast<double>(*num);
+	}
+	else {
+		return false;
+	}
+
+	return true;
+}
+
+bool OptionIndex::ToBool(const dpp::command_value& value, bool& out)
+{
+	if (const bool* flag = std::get_if<bool>(&value)) {
+		out = *flag;
+	}
+	else if (const int64_t* num = std::get_if<int64_t>(&value)) {
+		out = *num != 0;
+	}
+	else {
+		return false;
+	}
+
+	return true;
+}
+
+bool OptionIndex::GetString(const char* name, std::string& out) const
+{
+	int index = Find(name);
+	return index != -1 && ToString(m_options[index].value, out);
+}
+
+bool OptionIndex::GetInt(const char* name, int64_t& out) const
+{
+	int index = Find(name);
+	return index != -1 && ToInt(m_options[index].value, out);
+}
+
+bool OptionIndex::GetDouble(const char* name, double& out) const
+{
+	int index = Find(name);
+	return index != -1 && ToDouble(m_options[index].value, out);
+}
+
+bool OptionIndex::GetBool(const char* name, bool& out) const
+{
+	int index = Find(name);
+	return index != -1 && ToBool(m_options[index].value, out);
+}
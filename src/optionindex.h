@@ -0,0 +1,60 @@
+#ifndef _INCLUDE_OPTIONINDEX_H_
+#define _INCLUDE_OPTIONINDEX_H_
+
+#include "extension.h"
+
+struct IndexedOption
+{
+	std::string name;
+	dpp::command_option_type type;
+	dpp::command_value value;
+};
+
+/**
+ * @brief Flat, name-indexed view of the options of a slash command or
+ * autocomplete request.
+ *
+ * Built once per interaction on the gateway thread. Subcommand groups and
+ * subcommands are folded into the subcommand path, so only value options
+ * remain, in the order Discord sent them. The typed getters convert
+ * between compatible types and never throw.
+ */
+class OptionIndex
+{
+private:
+	std::vector<IndexedOption> m_options;
+	std::vector<uint8_t> m_byName;		// indexes into m_options, sorted by name
+	std::string m_subcommandPath;		// "group sub", "sub" or empty
+	int m_focused = -1;					// option being typed in, autocomplete only
+
+	template <typename Option>
+	void Build(const std::vector<Option>& options);
+
+public:
+	OptionIndex(const dpp::interaction& interaction);
+	OptionIndex(const std::vector<dpp::command_option>& options);
+
+	size_t GetCount() const { return m_options.size(); }
+	const IndexedOption& Get(size_t index) const { return m_options[index]; }
+	const char* GetSubcommandPath() const { return m_subcommandPath.c_str(); }
+	const IndexedOption* GetFocused() const { return m_focused != -1 ? &m_options[m_focused] : nullptr; }
+
+	/**
+	 * @brief Finds an option by name.
+	 *
+	 * @return Index of the option, or -1 if the command has no such option.
+	 */
+	int Find(const char* name) const;
+
+	static bool ToString(const dpp::command_value& value, std::string& out);
+	static bool ToInt(const dpp::command_value& value, int64_t& out);
+	static bool ToDouble(const dpp::command_value& value, double& out);
+	static bool ToBool(const dpp::command_value& value, bool& out);
+
+	bool GetString(const char* name, std::string& out) const;
+	bool GetInt(const char* name, int64_t& out) const;
+	bool GetDouble(const char* name, double& out) const;
+	bool GetBool(const char* name, bool& out) const;
+};
+
+#endif // _INCLUDE_OPTIONINDEX_H_
@@ -0,0 +1,155 @@
+#include "extension.h"
+
+static bool IsWordByte(uint8_t c)
+{
+	// Bytes of multi-byte UTF-8 sequences count as word characters
+	return c >= 0x80 || (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+PatternSet::PatternSet(const std::vector<std::string>& patterns, bool caseSensitive, bool wholeWords) :
+	m_caseSensitive(caseSensitive),
+	m_wholeWords(wholeWords),
+	m_numClasses(1)
+{
+	// Class 0 stands for every byte that appears in no pattern
+	memset(m_byteClass, 0, sizeof(m_byteClass));
+	for (const std::string& pattern : patterns) {
+		for (unsigned char c : pattern) {
+			uint8_t folded = Fold(c);
+			if (m_byteClass[folded] == 0) {
+				m_byteClass[folded] = static_cast<uint16_t>(m_numClasses++);
+			}
+		}
+	}
+	if (!m_caseSensitive) {
+		for (int c = 'A'; c <= 'Z'; c++) {
+			m_byteClass[c] = m_byteClass[c + ('a' - 'A')];
+		}
+	}
+
+	// Build the trie, -1 marks a missing edge
+	m_delta.assign(m_numClasses, -1);
+	m_output.assign(1, -1);
+
+	m_lengths.resize(patterns.size());
+	for (size_t i = 0; i < patterns.size(); i++) {
+		const std::string& pattern = patterns[i];
+		m_lengths[i] = static_cast<uint32_t>(pattern.length());
+		if (pattern.empty()) {
+			continue;
+		}
+
+		int32_t state = 0;
+		for (unsigned char c : pattern) {
+			size_t edge = state * m_numClasses + m_byteClass[c];
+			if (m_delta[edge] == -1) {
+				m_delta[edge] = static_cast<int32_t>(m_output.size());
+				m_output.push_back(-1);
+				m_delta.resize(m_delta.size() + m_numClasses, -1);
+			}
+			state = m_delta[edge];
+		}
+
+		if (m_output[state] == -1) {
+			m_output[state] = static_cast<int32_t>(i);
+		}
+	}
+
+	// Breadth-first pass turning the trie into a DFA and linking outputs along suffixes
+	std::vector<int32_t> fail(m_output.size(), 0);
+	m_outputLink.assign(m_output.size(), -1);
+	std::queue<int32_t> pending;
+
+	for (size_t c = 0; c < m_numClasses; c++) {
+		int32_t& next = m_delta[c];
+		if (next == -1) {
+			next = 0;
+		}
+		else {
+			pending.push(next);
+		}
+	}
+
+	while (!pending.empty()) {
+		int32_t state = pending.front();
+		pending.pop();
+
+		for (size_t c = 0; c < m_numClasses; c++) {
+			int32_t& next = m_delta[state * m_numClasses + c];
+			int32_t fallback = m_delta[fail[state] * m_numClasses + c];
+			if (next == -1) {
+				next = fallback;
+				continue;
+			}
+
+			fail[next] = fallback;
+			m_outputLink[next] = m_output[fallback] != -1 ? fallback : m_outputLink[fallback];
+			pending.push(next);
+		}
+	}
+}
+
+bool PatternSet::IsWholeWord(const char* text, size_t length, size_t start, size_t end) const
+{
+	if (start > 0 && IsWordByte(static_cast<uint8_t>(text[start - 1]))) {
+		return false;
+	}
+	if (end < length && IsWordByte(static_cast<uint8_t>(text[end]))) {
+		return false;
+	}
+	return true;
+}
+
+int PatternSet::FindFirst(const char* text, size_t length, size_t* start, size_t* matchLength) const
+{
+	if (m_lengths.empty()) {
+		return -1;
+	}
+
+	int32_t state = 0;
+	for (size_t i = 0; i < length; i++) {
+		state = m_delta[state * m_numClasses + m_byteClass[static_cast<uint8_t>(text[i])]];
+
+		for (int32_t out = m_output[state] != -1 ? state : m_outputLink[state]; out != -1; out = m_outputLink[out]) {
+			int32_t pattern = m_output[out];
+			size_t end = i + 1;
+			size_t begin = end - m_lengths[pattern];
+
+			if (m_wholeWords && !IsWholeWord(text, length, begin, end)) {
+				continue;
+			}
+
+			if (start) {
+				*start = begin;
+			}
+			if (matchLength) {
+				*matchLength = m_lengths[pattern];
+			}
+			return pattern;
+		}
+	}
+
+	return -1;
+}
+
+size_t PatternSet::CountMatches(const char* text, size_t length) const
+{
+	if (m_lengths.empty()) {
+		return 0;
+	}
+
+	size_t count = 0;
+	int32_t state = 0;
+	for (size_t i = 0; i < length; i++) {
+		state = m_delta[state * m_numClasses + m_byteClass[static_cast<uint8_t>(text[i])]];
+
+		for (int32_t out = m_output[state] != -1 ? state : m_outputLink[state]; out != -1; out = m_outputLink[out]) {
+			size_t end = i + 1;
+			if (!m_wholeWords || IsWholeWord(text, length, end - m_lengths[m_output[out]], end)) {
+				count++;
+			}
+		}
+	}
+
+	return count;
+}
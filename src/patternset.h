@@ -0,0 +1,62 @@
+#ifndef _INCLUDE_PATTERNSET_H_
+#define _INCLUDE_PATTERNSET_H_
+
+#include "extension.h"
+
+/**
+ * @brief An immutable set of literal patterns matched in a single pass.
+ * 
+ * Built once into an Aho-Corasick automaton, flattened to a dense DFA over
+ * the byte classes that actually occur in the patterns. Matching costs one
+ * table lookup per input byte regardless of the number of patterns.
+ * 
+ * Case folding is ASCII only; other bytes, including UTF-8 sequences, are
+ * compared as-is.
+ */
+class PatternSet
+{
+private:
+	bool m_caseSensitive;
+	bool m_wholeWords;
+
+	size_t m_numClasses;
+	uint16_t m_byteClass[256];
+
+	std::vector<int32_t> m_delta;		// state * m_numClasses + class -> state
+	std::vector<int32_t> m_output;		// pattern ending at this state, or -1
+	std::vector<int32_t> m_outputLink;	// next state on the suffix chain with an output, or -1
+	std::vector<uint32_t> m_lengths;	// pattern index -> length in bytes
+
+	uint8_t Fold(uint8_t c) const {
+		return (!m_caseSensitive && c >= 'A' && c <= 'Z') ? static_cast<uint8_t>(c + ('a' - 'A')) : c;
+	}
+
+	bool IsWholeWord(const char* text, size_t length, size_t start, size_t end) const;
+
+public:
+	PatternSet(const std::vector<std::string>& patterns, bool caseSensitive, bool wholeWords);
+
+	/**
+	 * @brief Finds the leftmost-ending match in a text.
+	 * 
+	 * @param text Text to scan.
+	 * @param length Length of the text in bytes.
+	 * @param[out] start Byte offset where the match starts.
+	 * @param[out] matchLength Length of the match in bytes.
+	 * @return Index of the matched pattern, or -1 if nothing matched.
+	 */
+	int FindFirst(const char* text, size_t length, size_t* start = nullptr, size_t* matchLength = nullptr) const;
+
+	/**
+	 * @brief Counts every, possibly overlapping, match in a text.
+	 */
+	size_t CountMatches(const char* text, size_t length) const;
+
+	bool Matches(const char* text, size_t length) const { return FindFirst(text, length) != -1; }
+	bool Matches(const std::string& text) const { return Matches(text.data(), text.length()); }
+
+	size_t GetPatternCount() const { return m_lengths.size(); }
+	size_t GetStateCount() const { return m_output.size(); }
+};
+
+#endif // _INCLUDE_PATTERNSET_H_
@@ -101,4 +101,148 @@ public:
 		std::lock_guard<std::mutex> lock(mutex);
 		return queue.size();
 	}
-};
\ No newline at end of file
+};
+
+/**
+ * @brief A bounded lock-free multi-producer/single-consumer queue.
+ * 
+ * Producers claim a slot in a fixed ring with a single CAS on the enqueue
+ * cursor and publish it through the slot's sequence number, so they never
+ * block each other or the consumer on a mutex. The consumer drains every
+ * published item in one pass after a single atomic read of the enqueue
+ * cursor.
+ * 
+ * If the ring is full, items spill into a mutex-protected overflow queue
+ * instead of being dropped. Producers keep using the overflow until the
+ * consumer has emptied it, which preserves FIFO order across the spill.
+ * 
+ * @tparam T The type of elements stored in the queue.
+ * @tparam Capacity Number of ring slots, must be a power of two.
+ */
+template <class T, size_t Capacity = 4096>
+class MpscQueue {
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+private:
+	struct Slot {
+		std::atomic<size_t> sequence;
+		T item;
+	};
+
+	alignas(64) std::atomic<size_t> m_enqueuePos;
+	alignas(64) size_t m_dequeuePos;
+	std::atomic<size_t> m_overflowSize;
+	std::unique_ptr<Slot[]> m_slots;
+	ThreadSafeQueue<T> m_overflow;
+
+	bool TryPushRing(T& item) {
+		size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+		for (;;) {
+			Slot& slot = m_slots[pos & (Capacity - 1)];
+			size_t seq = slot.sequence.load(std::memory_order_acquire);
+			intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+			if (diff == 0) {
+				if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					slot.item = std::move(item);
+					slot.sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0) {
+				return false;
+			}
+			else {
+				pos = m_enqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+public:
+	/**
+	 * @brief Default constructor.
+	 */
+	MpscQueue() : m_enqueuePos(0), m_dequeuePos(0), m_overflowSize(0), m_slots(new Slot[Capacity]) {
+		for (size_t i = 0; i < Capacity; i++) {
+			m_slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	/**
+	 * @brief Deleted copy constructor to prevent accidental copying.
+	 */
+	MpscQueue(const MpscQueue&) = delete;
+
+	/**
+	 * @brief Deleted assignment operator to prevent accidental assignment.
+	 */
+	MpscQueue& operator=(const MpscQueue&) = delete;
+
+	/**
+	 * @brief Pushes an item onto the queue. Safe to call from any thread.
+	 * 
+	 * @param item The item to be pushed.
+	 */
+	void Push(T item) {
+		if (m_overflowSize.load(std::memory_order_acquire) == 0 && TryPushRing(item)) {
+			return;
+		}
+
+		m_overflowSize.fetch_add(1, std::memory_order_acq_rel);
+		m_overflow.Push(std::move(item));
+	}
+
+	/**
+	 * @brief Moves every item published so far to the back of a container.
+	 * 
+	 * Must only be called from the consumer thread.
+	 * 
+	 * @param[out] out Container receiving the items, in FIFO order.
+	 * @return The number of items moved.
+	 */
+	template <class Container>
+	size_t Drain(Container& out) {
+		size_t count = 0;
+		const size_t end = m_enqueuePos.load(std::memory_order_acquire);
+
+		while (m_dequeuePos != end) {
+			Slot& slot = m_slots[m_dequeuePos & (Capacity - 1)];
+			if (slot.sequence.load(std::memory_order_acquire) != m_dequeuePos + 1) {
+				// Claimed by a producer that has not published yet; pick it up next time.
+				return count;
+			}
+
+			out.push_back(std::move(slot.item));
+			slot.item = T();
+			slot.sequence.store(m_dequeuePos + Capacity, std::memory_order_release);
+			m_dequeuePos++;
+			count++;
+		}
+
+		// Only take from the overflow once the ring is empty, so items a producer
+		// pushed to the ring before spilling are never overtaken.
+		if (m_overflowSize.load(std::memory_order_acquire) != 0
+			&& m_enqueuePos.load(std::memory_order_acquire) == m_dequeuePos) {
+			T item;
+			while (m_overflow.TryPop(item)) {
+				out.push_back(std::move(item));
+				m_overflowSize.fetch_sub(1, std::memory_order_acq_rel);
+				count++;
+			}
+		}
+
+		return count;
+	}
+
+	/**
+	 * @brief Checks if the queue is empty.
+	 * 
+	 * The result is only a snapshot while producers are running.
+	 * 
+	 * @return true if the queue is empty, false otherwise.
+	 */
+	bool Empty() const {
+		return m_enqueuePos.load(std::memory_order_acquire) == m_dequeuePos
+			&& m_overflowSize.load(std::memory_order_acquire) == 0;
+	}
+};
@@ -14,5 +14,8 @@
 
 #define SMEXT_ENABLE_HANDLESYS
 #define SMEXT_ENABLE_FORWARDSYS
+#define SMEXT_ENABLE_TIMERSYS
+#define SMEXT_ENABLE_PLUGINSYS
+#define SMEXT_ENABLE_LIBSYS
 
 #endif // _INCLUDE_SOURCEMOD_EXTENSION_CONFIG_H_
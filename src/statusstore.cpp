@@ -0,0 +1,67 @@
+#include "extension.h"
+
+std::string StatusStore::Render(const std::string& text, const StatusValues* values)
+{
+	if (!values || text.find('{') == std::string::npos) {
+		return text;
+	}
+
+	std::string out;
+	out.reserve(text.length());
+
+	size_t pos = 0;
+	while (pos < text.length()) {
+		size_t open = text.find('{', pos);
+		if (open == std::string::npos) {
+			break;
+		}
+
+		size_t close = text.find('}', open + 1);
+		if (close == std::string::npos) {
+			break;
+		}
+
+		out.append(text, pos, open - pos);
+
+		auto it = values->find(text.substr(open + 1, close - open - 1));
+		if (it != values->end()) {
+			out.append(it->second);
+		}
+		else {
+			out.append(text, open, close - open + 1);
+		}
+		pos = close + 1;
+	}
+
+	out.append(text, pos, std::string::npos);
+	return out;
+}
+
+dpp::message StatusStore::Render(const StaticResponse& response, const StatusValues* values)
+{
+	dpp::message msg(Render(response.content, values));
+
+	if (response.embed) {
+		dpp::embed embed = *response.embed;
+		embed.title = Render(embed.title, values);
+		embed.description = Render(embed.description, values);
+		embed.url = Render(embed.url, values);
+		if (embed.footer) {
+			embed.footer->text = Render(embed.footer->text, values);
+		}
+		if (embed.author) {
+			embed.author->name = Render(embed.author->name, values);
+		}
+		for (dpp::embed_field& field : embed.fields) {
+			field.name = Render(field.name, values);
+			field.value = Render(field.value, values);
+		}
+		msg.add_embed(embed);
+	}
+
+	if (response.ephemeral) {
+		msg.set_flags(dpp::m_ephemeral);
+	}
+
+	return msg;
+}
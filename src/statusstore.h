@@ -0,0 +1,61 @@
+#ifndef _INCLUDE_STATUSSTORE_H_
+#define _INCLUDE_STATUSSTORE_H_
+
+#include "extension.h"
+
+typedef std::unordered_map<std::string, std::string> StatusValues;
+
+/**
+ * @brief Command answered from the status snapshot without involving plugins.
+ * 
+ * Text in the content and embed may contain {key} placeholders that are
+ * replaced with the published status values.
+ */
+struct StaticResponse
+{
+	std::string content;
+	std::optional<dpp::embed> embed;
+	bool ephemeral = false;
+};
+
+typedef std::unordered_map<std::string, StaticResponse> StaticResponseMap;
+
+/**
+ * @brief Double-buffered key/value status published by plugins.
+ * 
+ * Plugins write to a staging copy on the main thread and publish it as a
+ * whole, readers on DPP threads always see a complete snapshot without
+ * locking.
+ */
+class StatusStore
+{
+private:
+	StatusValues m_staging;
+	std::shared_ptr<const StatusValues> m_published;
+
+public:
+	void Set(const std::string& key, std::string value) { m_staging[key] = std::move(value); }
+	bool Remove(const std::string& key) { return m_staging.erase(key) > 0; }
+
+	/**
+	 * @brief Makes the staged values visible to readers.
+	 */
+	void Publish() { std::atomic_store(&m_published, std::make_shared<const StatusValues>(m_staging)); }
+
+	/**
+	 * @brief Gets the last published values. Safe to call from any thread.
+	 */
+	std::shared_ptr<const StatusValues> GetPublished() const { return std::atomic_load(&m_published); }
+
+	/**
+	 * @brief Replaces {key} placeholders in a template, unknown keys are kept as written.
+	 */
+	static std::string Render(const std::string& text, const StatusValues* values);
+
+	/**
+	 * @brief Builds the reply of a static response from the given values.
+	 */
+	static dpp::message Render(const StaticResponse& response, const StatusValues* values);
+};
+
+#endif // _INCLUDE_STATUSSTORE_H_
@@ -0,0 +1,59 @@
+#include "extension.h"
+
+EventSubscriptions g_Subscriptions;
+
+static const char* const g_EventForwardNames[EventKind_Count] = {
+	"Discord_OnMessage",
+	"Discord_OnSlashCommand",
+	"Discord_OnAutocomplete",
+	"Discord_OnError",
+	"Discord_OnMessageBatch",
+};
+
+static IForward* GetEventForward(EventKind kind)
+{
+	switch (kind) {
+		case EventKind_Message:
+			return g_pForwardMessage;
+		case EventKind_SlashCommand:
+			return g_pForwardSlashCommand;
+		case EventKind_Autocomplete:
+			return g_pForwardAutocomplete;
+		case EventKind_Error:
+			return g_pForwardError;
+		case EventKind_MessageBatch:
+			return g_pForwardMessageBatch;
+		default:
+			return nullptr;
+	}
+}
+
+EventSubscriptions::EventSubscriptions()
+{
+	for (int i = 0; i < EventKind_Count; i++) {
+		m_subscribed[i].store(false, std::memory_order_relaxed);
+	}
+}
+
+void EventSubscriptions::Refresh()
+{
+	for (int i = 0; i < EventKind_Count; i++) {
+		IForward* forward = GetEventForward(static_cast<EventKind>(i));
+		m_subscribed[i].store(forward && forward->GetFunctionCount() > 0, std::memory_order_relaxed);
+	}
+}
+
+void EventSubscriptions::AddPlugin(IPlugin* plugin)
+{
+	IPluginRuntime* runtime = plugin->GetRuntime();
+	if (!runtime) {
+		return;
+	}
+
+	for (int i = 0; i < EventKind_Count; i++) {
+		uint32_t index;
+		if (runtime->FindPublicByName(g_EventForwardNames[i], &index) == SP_ERROR_NONE) {
+			m_subscribed[i].store(true, std::memory_order_relaxed);
+		}
+	}
+}
@@ -0,0 +1,52 @@
+#ifndef _INCLUDE_SUBSCRIPTIONS_H_
+#define _INCLUDE_SUBSCRIPTIONS_H_
+
+#include "extension.h"
+
+enum EventKind
+{
+	EventKind_Message = 0,
+	EventKind_SlashCommand,
+	EventKind_Autocomplete,
+	EventKind_Error,
+	EventKind_MessageBatch,
+	EventKind_Count
+};
+
+/**
+ * @brief Tracks which gateway events any plugin listens to.
+ * 
+ * Written on the main thread as plugins load and unload, read by DPP
+ * threads so events nobody listens to are dropped before they are copied
+ * and queued.
+ */
+class EventSubscriptions
+{
+private:
+	std::atomic<bool> m_subscribed[EventKind_Count];
+
+public:
+	EventSubscriptions();
+
+	/**
+	 * @brief Checks if an event has any listener. Safe to call from any thread.
+	 */
+	bool IsSubscribed(EventKind kind) const { return m_subscribed[kind].load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief Recomputes the state from the forwards' current listeners.
+	 */
+	void Refresh();
+
+	/**
+	 * @brief Marks events the plugin has public callbacks for as subscribed.
+	 * 
+	 * Covers the window before the forwards pick up a plugin that has just
+	 * loaded.
+	 */
+	void AddPlugin(IPlugin* plugin);
+};
+
+extern EventSubscriptions g_Subscriptions;
+
+#endif // _INCLUDE_SUBSCRIPTIONS_H_
@@ -0,0 +1,234 @@
+#ifndef _INCLUDE_TASK_H_
+#define _INCLUDE_TASK_H_
+
+#include "extension.h"
+
+#define TASK_INLINE_SIZE 48
+
+/**
+ * @brief A fixed set of equally sized memory blocks shared by all threads.
+ * 
+ * Blocks are claimed with a single atomic exchange on a per-block flag and
+ * released with a store, so producers on DPP threads and the consumer on the
+ * main thread never take a lock or touch the general-purpose heap.
+ * 
+ * @tparam BlockSize Size of each block in bytes.
+ * @tparam BlockCount Number of blocks in the pool.
+ */
+template <size_t BlockSize, size_t BlockCount>
+class TaskBlockPool {
+private:
+	struct alignas(alignof(std::max_align_t)) Block {
+		unsigned char data[BlockSize];
+	};
+
+	std::unique_ptr<Block[]> m_blocks;
+	std::unique_ptr<std::atomic<bool>[]> m_used;
+	std::atomic<size_t> m_hint;
+
+public:
+	TaskBlockPool() : m_blocks(new Block[BlockCount]), m_used(new std::atomic<bool>[BlockCount]), m_hint(0) {
+		for (size_t i = 0; i < BlockCount; i++) {
+			m_used[i].store(false, std::memory_order_relaxed);
+		}
+	}
+
+	TaskBlockPool(const TaskBlockPool&) = delete;
+	TaskBlockPool& operator=(const TaskBlockPool&) = delete;
+
+	/**
+	 * @brief Claims a free block.
+	 * 
+	 * @return The block, or nullptr if every block is in use.
+	 */
+	void* Allocate() {
+		const size_t start = m_hint.fetch_add(1, std::memory_order_relaxed);
+		for (size_t i = 0; i < BlockCount; i++) {
+			const size_t index = (start + i) % BlockCount;
+			if (!m_used[index].load(std::memory_order_relaxed) && !m_used[index].exchange(true, std::memory_order_acquire)) {
+				return m_blocks[index].data;
+			}
+		}
+		return nullptr;
+	}
+
+	bool Owns(const void* ptr) const {
+		const Block* block = static_cast<const Block*>(ptr);
+		return block >= m_blocks.get() && block < m_blocks.get() + BlockCount;
+	}
+
+	void Free(void* ptr) {
+		const size_t index = static_cast<Block*>(ptr) - m_blocks.get();
+		m_used[index].store(false, std::memory_order_release);
+	}
+};
+
+/**
+ * @brief Counters of where Task storage came from.
+ */
+struct TaskAllocStats {
+	std::atomic<uint64_t> inlined{0};
+	std::atomic<uint64_t> pooled{0};
+	std::atomic<uint64_t> heap{0};
+};
+
+/**
+ * @brief Move-only, type-erased callable for the main-thread handoff.
+ * 
+ * Small callables live in an inline buffer. Larger ones, such as lambdas
+ * carrying a whole dpp::message or slashcommand_t, are placed in blocks from
+ * size-classed TaskBlockPools. Only a callable too big for every class, or
+ * one arriving while its pool is exhausted, falls back to the heap.
+ */
+class Task {
+private:
+	typedef TaskBlockPool<256, 512> SmallPool;
+	typedef TaskBlockPool<1536, 256> MediumPool;
+	typedef TaskBlockPool<3072, 128> LargePool;
+
+	struct Ops {
+		void (*invoke)(void* callable);
+		void (*relocate)(void* dst, void* src);
+		void (*destroy)(void* callable);
+	};
+
+	template <class F>
+	static const Ops* OpsFor() {
+		static const Ops ops = {
+			[](void* callable) { (*static_cast<F*>(callable))(); },
+			[](void* dst, void* src) { new (dst) F(std::move(*static_cast<F*>(src))); static_cast<F*>(src)->~F(); },
+			[](void* callable) { static_cast<F*>(callable)->~F(); },
+		};
+		return &ops;
+	}
+
+	static SmallPool& GetSmallPool() { static SmallPool pool; return pool; }
+	static MediumPool& GetMediumPool() { static MediumPool pool; return pool; }
+	static LargePool& GetLargePool() { static LargePool pool; return pool; }
+
+	static void* AllocateBlock(size_t size) {
+		void* block = nullptr;
+		if (size <= 256) {
+			block = GetSmallPool().Allocate();
+		}
+		else if (size <= 1536) {
+			block = GetMediumPool().Allocate();
+		}
+		else if (size <= 3072) {
+			block = GetLargePool().Allocate();
+		}
+
+		if (block) {
+			GetAllocStats().pooled.fetch_add(1, std::memory_order_relaxed);
+			return block;
+		}
+
+		GetAllocStats().heap.fetch_add(1, std::memory_order_relaxed);
+		return ::operator new(size);
+	}
+
+	static void FreeBlock(void* block) {
+		if (GetSmallPool().Owns(block)) {
+			GetSmallPool().Free(block);
+		}
+		else if (GetMediumPool().Owns(block)) {
+			GetMediumPool().Free(block);
+		}
+		else if (GetLargePool().Owns(block)) {
+			GetLargePool().Free(block);
+		}
+		else {
+			::operator delete(block);
+		}
+	}
+
+	alignas(alignof(std::max_align_t)) unsigned char m_inline[TASK_INLINE_SIZE];
+	void* m_callable;
+	const Ops* m_ops;
+
+	bool IsInline() const { return m_callable == m_inline; }
+
+	void Reset() {
+		if (!m_ops) {
+			return;
+		}
+
+		m_ops->destroy(m_callable);
+		if (!IsInline()) {
+			FreeBlock(m_callable);
+		}
+
+		m_callable = nullptr;
+		m_ops = nullptr;
+	}
+
+	void MoveFrom(Task& other) {
+		m_ops = other.m_ops;
+		if (!m_ops) {
+			m_callable = nullptr;
+			return;
+		}
+
+		if (other.IsInline()) {
+			m_callable = m_inline;
+			m_ops->relocate(m_inline, other.m_inline);
+		}
+		else {
+			m_callable = other.m_callable;
+		}
+
+		other.m_callable = nullptr;
+		other.m_ops = nullptr;
+	}
+
+public:
+	Task() : m_callable(nullptr), m_ops(nullptr) {}
+
+	template <class F, class = typename std::enable_if<!std::is_same<typename std::decay<F>::type, Task>::value>::type>
+	Task(F&& func) {
+		typedef typename std::decay<F>::type Callable;
+		static_assert(alignof(Callable) <= alignof(std::max_align_t), "Over-aligned callables are not supported");
+
+		if (sizeof(Callable) <= TASK_INLINE_SIZE && std::is_nothrow_move_constructible<Callable>::value) {
+			m_callable = m_inline;
+			GetAllocStats().inlined.fetch_add(1, std::memory_order_relaxed);
+		}
+		else {
+			m_callable = AllocateBlock(sizeof(Callable));
+		}
+
+		try {
+			new (m_callable) Callable(std::forward<F>(func));
+		}
+		catch (...) {
+			if (!IsInline()) {
+				FreeBlock(m_callable);
+			}
+			throw;
+		}
+		m_ops = OpsFor<Callable>();
+	}
+
+	Task(Task&& other) noexcept { MoveFrom(other); }
+
+	Task& operator=(Task&& other) noexcept {
+		if (this != &other) {
+			Reset();
+			MoveFrom(other);
+		}
+		return *this;
+	}
+
+	Task(const Task&) = delete;
+	Task& operator=(const Task&) = delete;
+
+	~Task() { Reset(); }
+
+	void operator()() { m_ops->invoke(m_callable); }
+
+	explicit operator bool() const { return m_ops != nullptr; }
+
+	static TaskAllocStats& GetAllocStats() { static TaskAllocStats stats; return stats; }
+};
+
+#endif // _INCLUDE_TASK_H_